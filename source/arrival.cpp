@@ -0,0 +1,65 @@
+#include "parser.h"
+#include "modeling.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <set>
+#include <cmath>
+#include <algorithm>
+
+// Час надходження змінних у тактах моделі: "A=0, B=0, C=12" (змінні без запису — у момент 0)
+bool parseArrivalTimes(const std::string& text, std::map<std::string, int>& arrival) {
+    std::map<std::string, double> values;
+    if (!parseBindings(text, values)) return false;
+    for (const auto& [name, time] : values) {
+        if (time < 0) {
+            std::cout << "Error: negative arrival time for '" << name << "'" << std::endl;
+            return false;
+        }
+        arrival[name] = (int)std::lround(time);
+    }
+    return true;
+}
+
+namespace {
+
+void reportPlan(prsr::Node* tree, int procCount, const std::map<std::string, int>& arrival, bool gantt) {
+    auto assignments = assignTasksWithDependencies(tree, procCount, arrival);
+    int makespan = 0;
+    std::set<int> usedProcs;
+    for (const auto& t : assignments) {
+        makespan = std::max(makespan, t.endTime);
+        usedProcs.insert(t.proc);
+    }
+    std::cout << "Critical path with arrivals: " << criticalPathLength(tree, arrival) << std::endl;
+    std::cout << "Makespan: " << makespan << " on " << usedProcs.size() << " of " << procCount << " processors" << std::endl;
+    if (gantt) printGanttTable(assignments, procCount);
+}
+
+} // namespace
+
+// === Планування з урахуванням часу надходження вхідних даних ===
+void prsr::modelArrivals(const std::string& expr, const std::string& arrivalSpec, int procCount) {
+    if (!validateExpression(expr)) {
+        std::cout << "Error: the expression is not valid!" << std::endl;
+        return;
+    }
+    std::map<std::string, int> arrival;
+    if (!parseArrivalTimes(arrivalSpec, arrival)) return;
+    prsr::Node* balanced = prsr::optimizeParallelTree(buildOptimizedTree(expr));
+    prsr::Node* aware = prsr::optimizeParallelTree(buildOptimizedTree(expr), arrival);
+    if (!balanced || !aware) {
+        std::cout << "Error: failed to build the tree!" << std::endl;
+        delete balanced;
+        delete aware;
+        return;
+    }
+
+    std::cout << "\n=== Tree balanced for inputs ready at t=0, real arrivals ===" << std::endl;
+    reportPlan(balanced, procCount, arrival, false);
+    std::cout << "\n=== Tree restructured by arrival times ===" << std::endl;
+    reportPlan(aware, procCount, arrival, true);
+
+    delete balanced;
+    delete aware;
+}
@@ -0,0 +1,253 @@
+#include "cache.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <algorithm>
+
+const CachedSchedule* CachedResult::schedule(int procCount) const {
+    materialize();
+    for (const auto& s : schedules) {
+        if (s.procCount == procCount) return &s;
+    }
+    return nullptr;
+}
+
+bool CachedResult::hasSchedule(int procCount) const {
+    for (const auto& s : schedules) {
+        if (s.procCount == procCount) return true;
+    }
+    return false;
+}
+
+// Оцінка зайнятої пам'яті: вузли дерева, рядки і плани. Поки запис з диска не розгорнуто,
+// дерево і призначення ще не існують — рахується лише закодований блок
+size_t CachedResult::bytes() const {
+    size_t total = sizeof(CachedResult) + corrected.capacity() + encoded.capacity();
+    if (!encoded.empty() && !decoded.load(std::memory_order_acquire)) {
+        return total + schedules.capacity() * sizeof(CachedSchedule);
+    }
+    std::vector<const prsr::Node*> stack = {tree};
+    while (!stack.empty()) {
+        const prsr::Node* n = stack.back();
+        stack.pop_back();
+        if (!n) continue;
+        total += sizeof(prsr::Node) + n->value.capacity() + n->children.capacity() * sizeof(prsr::Node*);
+        for (const prsr::Node* child : n->children) stack.push_back(child);
+    }
+    for (const auto& s : schedules) {
+        total += sizeof(CachedSchedule) + s.assignments.capacity() * sizeof(TaskAssignment);
+        for (const auto& t : s.assignments) total += t.op.capacity();
+    }
+    return total;
+}
+
+ResultCache::ResultCache(size_t capacityBytes, int shardCount)
+    : shards(std::make_unique<Shard[]>(std::max(1, shardCount))),
+      shardCount(std::max(1, shardCount)),
+      shardCapacity(capacityBytes / std::max(1, shardCount)) {}
+
+std::shared_ptr<const CachedResult> ResultCache::find(const prsr::Hash128& key, bool countMiss) {
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+        if (countMiss) shard.misses++;
+        return nullptr;
+    }
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    shard.hits++;
+    shard.savedSeconds += it->second->value->computeSeconds;
+    return it->second->value;
+}
+
+void ResultCache::insert(const prsr::Hash128& key, std::shared_ptr<const CachedResult> value) {
+    size_t bytes = value->bytes() + sizeof(Entry);
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        shard.bytes -= it->second->bytes;
+        shard.lru.erase(it->second);
+        shard.index.erase(it);
+    }
+    // Запис, більший за шард, не кешується взагалі
+    if (bytes > shardCapacity) return;
+    while (shard.bytes + bytes > shardCapacity && !shard.lru.empty()) {
+        shard.bytes -= shard.lru.back().bytes;
+        shard.index.erase(shard.lru.back().key);
+        shard.lru.pop_back();
+        shard.evictions++;
+    }
+    shard.lru.push_front({key, std::move(value), bytes});
+    shard.index[key] = shard.lru.begin();
+    shard.bytes += bytes;
+}
+
+void ResultCache::clear() {
+    for (size_t i = 0; i < shardCount; ++i) {
+        std::lock_guard<std::mutex> lock(shards[i].mutex);
+        shards[i].lru.clear();
+        shards[i].index.clear();
+        shards[i].bytes = 0;
+    }
+}
+
+CacheStats ResultCache::stats() const {
+    CacheStats total;
+    total.capacityBytes = shardCapacity * shardCount;
+    for (size_t i = 0; i < shardCount; ++i) {
+        Shard& shard = shards[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total.hits += shard.hits;
+        total.misses += shard.misses;
+        total.evictions += shard.evictions;
+        total.entries += shard.lru.size();
+        total.bytes += shard.bytes;
+        total.savedSeconds += shard.savedSeconds;
+    }
+    return total;
+}
+
+ResultCache& resultCache() {
+    static ResultCache cache;
+    return cache;
+}
+
+std::shared_ptr<const CachedResult> analyzeExpression(const std::string& expr, const std::vector<int>& procCounts,
+                                                      ResultCache& cache) {
+    auto t0 = std::chrono::steady_clock::now();
+    std::string normalized = expr;
+    normalized.erase(std::remove_if(normalized.begin(), normalized.end(), ::isspace), normalized.end());
+    // Спершу — за текстом: повторний запит того самого рядка не розбирається взагалі
+    prsr::Hash128 textKey = prsr::textHash(normalized);
+    PersistentCache* store = cache.store();
+    std::shared_ptr<const CachedResult> cached = cache.find(textKey, false);
+    if (!cached && store) {
+        cached = store->find(textKey, false);
+        if (cached) cache.insert(textKey, cached);
+    }
+    prsr::Hash128 key;
+    if (!cached) {
+        // Новий запис тексту: структурний ключ знаходить той самий вираз в іншому записі
+        key = prsr::expressionHash(normalized);
+        cached = cache.find(key);
+        if (!cached && store) {
+            cached = store->find(key);
+            if (cached) cache.insert(key, cached);
+        }
+        if (cached) {
+            cache.insert(textKey, cached);
+            if (store) store->insertAlias(textKey, key);
+        }
+    }
+    bool complete = cached != nullptr;
+    for (int p : procCounts) complete = complete && cached->hasSchedule(p);
+    if (complete) return cached;
+
+    if (key.empty()) key = prsr::expressionHash(normalized);
+    auto result = std::make_shared<CachedResult>();
+    if (cached) {
+        // Бракує планів для нових procCount: дерево і текст беремо з кешу
+        cached->materialize();
+        result->corrected = cached->corrected;
+        result->valid = cached->valid;
+        result->tree = prsr::cloneSubtree(cached->tree);
+        result->schedules = cached->schedules;
+    } else {
+        result->corrected = FullySimplifyAndCorrect(normalized);
+        {
+            std::lock_guard<std::mutex> lock(parserErrorsMutex);
+            prsr::errors.clear();
+            prsr::checkExpression(result->corrected.c_str());
+            result->valid = prsr::errors.empty() && !result->corrected.empty();
+            prsr::errors.clear();
+        }
+        if (result->valid) result->tree = prsr::optimizeParallelTree(buildOptimizedTree(result->corrected));
+        result->valid = result->valid && result->tree;
+    }
+    std::vector<int> missing;
+    for (int p : procCounts) {
+        if (result->valid && !result->schedule(p)) missing.push_back(p);
+    }
+    if (!missing.empty()) {
+        // Граф і рівні дерева не залежать від P — один аналіз на всі відсутні плани
+        SweepAnalysis analysis = analyzeForSweep(result->tree);
+        for (auto& point : sweepProcessors(analysis, missing, 1, true).points) {
+            CachedSchedule s;
+            s.procCount = point.procCount;
+            s.assignments = std::move(point.assignments);
+            s.seqTime = analysis.levels;
+            s.makespan = point.makespan;
+            s.usedProcs = point.usedProcs;
+            result->schedules.push_back(std::move(s));
+        }
+    }
+    result->computeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count() +
+                             (cached ? cached->computeSeconds : 0.0);
+    cache.insert(key, result);
+    cache.insert(textKey, result);
+    if (store) {
+        store->insert(key, *result);
+        if (!cached) store->insertAlias(textKey, key);
+    }
+    return result;
+}
+
+void printCacheStats(const CacheStats& stats) {
+    std::cout << "Cache: " << stats.entries << " entries, " << std::fixed << std::setprecision(1)
+              << stats.bytes / 1024.0 << " / " << stats.capacityBytes / 1024.0 << " KiB, hit rate "
+              << std::setprecision(1) << stats.hitRate() * 100.0 << "% (" << stats.hits << " hits, "
+              << stats.misses << " misses), " << stats.evictions << " evictions, latency saved "
+              << std::setprecision(2) << stats.savedSeconds * 1e3 << " ms"
+              << std::defaultfloat << std::setprecision(6) << std::endl;
+}
+
+// === Кеш на повторюваному навантаженні: ті самі вирази з різним записом ===
+void prsr::benchmarkResultCache() {
+    const std::vector<std::string> base = {
+        "A/B+C*D-E/F+G+H*A/B-C+D*E*F", "A*B+A*C+A*D+E*F-E*G", "(A+B)*(C+D)*E*F+G/H/A+B+C",
+        "A+B+C+D+E+F+G+H", "A/B/C/D+E+F+G+H", "A*B*C*D*E*F*G*H", "(A-B)/(C-D)+E+F+G+H*A*B*C",
+    };
+    // Варіанти запису: переставлені доданки, зайві дужки, пробіли
+    std::vector<std::string> spellings;
+    for (const auto& e : base) {
+        spellings.push_back(e);
+        spellings.push_back("(" + e + ")");
+        spellings.push_back(" " + e + " ");
+    }
+    spellings.push_back("H+G+F+E+D+C+B+A");
+    spellings.push_back("(A+B)+(C+D)+(E+F)+(G+H)");
+    spellings.push_back("H*G*F*E*D*C*B*A");
+    const std::vector<int> procCounts = {1, 2, 5, 6, 8, 10};
+    const int requests = 4000;
+    const int threads = 4;
+
+    std::cout << "\n=== Result cache: " << requests << " requests over " << spellings.size()
+              << " spellings, " << threads << " threads ===" << std::endl;
+    for (bool cached : {false, true}) {
+        ResultCache cache(1u << 20, 16);
+        auto t0 = std::chrono::steady_clock::now();
+        std::vector<std::thread> pool;
+        for (int t = 0; t < threads; ++t) {
+            pool.emplace_back([&, t] {
+                std::mt19937 rng(t + 1);
+                for (int i = 0; i < requests / threads; ++i) {
+                    const std::string& expr = spellings[rng() % spellings.size()];
+                    if (cached) {
+                        analyzeExpression(expr, procCounts, cache);
+                    } else {
+                        ResultCache scratch(1u << 20, 1);
+                        analyzeExpression(expr, procCounts, scratch);
+                    }
+                }
+            });
+        }
+        for (auto& t : pool) t.join();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        std::cout << (cached ? "With cache:    " : "Without cache: ") << std::fixed << std::setprecision(2)
+                  << seconds * 1e3 << " ms" << std::defaultfloat << std::setprecision(6) << std::endl;
+        if (cached) printCacheStats(cache.stats());
+    }
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "parser.h"
+#include "modeling.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// План для однієї кількості процесорів
+struct CachedSchedule {
+    int procCount = 0;
+    std::vector<TaskAssignment> assignments;
+    int seqTime = 0;        // кількість рівнів дерева, як у modelSystem
+    int makespan = 0;
+    int usedProcs = 0;
+};
+
+// Результат повного аналізу виразу: виправлений текст, оптимізоване дерево і плани.
+// Запис, прочитаний з диска, тримає копію закодованого блоку: вузли дерева і призначення
+// планів будуються з нього лише при першому зверненні (root, schedule, materialize).
+struct CachedResult {
+    std::string corrected;
+    bool valid = false;
+    mutable prsr::Node* tree = nullptr;     // після optimizeParallelTree, належить запису
+    mutable std::vector<CachedSchedule> schedules;  // для запису з диска до materialize — без assignments
+    double computeSeconds = 0.0;            // скільки коштувало обчислення — економія на кожному влучанні
+    std::string encoded;                    // блок encodeCachedResult, якщо запис прочитано з диска
+
+    CachedResult() = default;
+    CachedResult(const CachedResult&) = delete;
+    CachedResult& operator=(const CachedResult&) = delete;
+    ~CachedResult() { delete tree; }
+
+    prsr::Node* root() const { materialize(); return tree; }
+    const CachedSchedule* schedule(int procCount) const;
+    bool hasSchedule(int procCount) const;  // без побудови планів
+    void materialize() const;
+    size_t bytes() const;
+
+private:
+    mutable std::once_flag decodeOnce;
+    mutable std::atomic<bool> decoded{false};
+};
+
+struct CacheStats {
+    long long hits = 0;
+    long long misses = 0;
+    long long evictions = 0;
+    size_t entries = 0;
+    size_t bytes = 0;
+    size_t capacityBytes = 0;
+    double savedSeconds = 0.0;              // сума computeSeconds по влучаннях
+
+    double hitRate() const { return hits + misses > 0 ? (double)hits / (hits + misses) : 0.0; }
+};
+
+class PersistentCache;
+
+// Потокобезпечний LRU-кеш, поділений на шарди з власними м'ютексами. Кожен результат лежить
+// під двома ключами: textHash нормалізованого тексту (пошук без розбору) і структурний хеш
+// виразу, тож однакові вирази з різним записом (C+B+A і A+(B+C)) теж дають влучання.
+// Спільний запис враховується в обсязі під кожним ключем — оцінка пам'яті лише завищується.
+// Обсяг пам'яті обмежений capacityBytes; записи, які ще використовуються, живуть через shared_ptr.
+class ResultCache {
+public:
+    explicit ResultCache(size_t capacityBytes = 64u << 20, int shardCount = 16);
+
+    // countMiss = false — пробний пошук, промах якого не враховується в статистиці
+    std::shared_ptr<const CachedResult> find(const prsr::Hash128& key, bool countMiss = true);
+    void insert(const prsr::Hash128& key, std::shared_ptr<const CachedResult> value);
+    void clear();
+    CacheStats stats() const;
+
+    // Постійне сховище другого рівня: промахи шукаються в ньому, нові записи дописуються туди ж
+    void attach(PersistentCache* store) { backing = store; }
+    PersistentCache* store() const { return backing; }
+
+private:
+    struct Entry {
+        prsr::Hash128 key;
+        std::shared_ptr<const CachedResult> value;
+        size_t bytes = 0;
+    };
+
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::list<Entry> lru;               // спереду — нещодавно використані
+        std::unordered_map<prsr::Hash128, std::list<Entry>::iterator, prsr::Hash128Hasher> index;
+        size_t bytes = 0;
+        long long hits = 0;
+        long long misses = 0;
+        long long evictions = 0;
+        double savedSeconds = 0.0;
+    };
+
+    Shard& shardFor(const prsr::Hash128& key) { return shards[key.hi % shardCount]; }
+
+    std::unique_ptr<Shard[]> shards;
+    size_t shardCount;
+    size_t shardCapacity;
+    std::atomic<PersistentCache*> backing{nullptr};
+};
+
+struct PersistentStats {
+    long long hits = 0;
+    long long misses = 0;
+    long long appends = 0;
+    long long rejected = 0;       // записи з пошкодженою контрольною сумою або за межею журналу
+    size_t entries = 0;
+    size_t slots = 0;
+    uint64_t logBytes = 0;        // зайнято в журналі, включно з перезаписаними записами
+    uint64_t liveBytes = 0;       // з них — на записи, на які ще вказує таблиця
+    uint64_t fileBytes = 0;
+};
+
+// Файловий кеш результатів, відображений у пам'ять. Файл — це заголовок, хеш-таблиця з
+// відкритою адресацією (ключ -> зміщення запису) і журнал записів, який лише дописується.
+// Записи двох видів: результат під структурним ключем і псевдонім textHash -> структурний
+// ключ. Пошук за текстом не розбирає вираз, а влучання копіює блок запису без декодування.
+// Порядок запису (запис у журнал, межа журналу в заголовку, комірка таблиці) гарантує, що
+// після збою таблиця не вказує на недописаний запис. compact() переписує живі записи в
+// новий файл і атомарно підміняє старий.
+class PersistentCache {
+public:
+    PersistentCache();
+    ~PersistentCache();
+    PersistentCache(const PersistentCache&) = delete;
+    PersistentCache& operator=(const PersistentCache&) = delete;
+
+    bool open(const std::string& path, size_t initialSlots = 4096);
+    void close();
+    bool isOpen() const;
+
+    // Ключ-псевдонім розв'язується в ключ результату тут же
+    std::shared_ptr<const CachedResult> find(const prsr::Hash128& key, bool countMiss = true);
+    bool insert(const prsr::Hash128& key, const CachedResult& value);
+    bool insertAlias(const prsr::Hash128& alias, const prsr::Hash128& key);
+    bool compact();
+    void flush();
+    PersistentStats stats() const;
+
+    struct MappedFile;
+
+private:
+    bool compactLocked();
+    bool remap(uint64_t newSize);
+    size_t countEntries() const;
+    bool appendLocked(const prsr::Hash128& key, uint32_t kind, const std::string& payload);
+    bool appendRecord(const prsr::Hash128& key, uint32_t kind, const std::string& payload, uint64_t& offset);
+    bool readRecord(uint64_t offset, const prsr::Hash128& key, const char*& payload, uint32_t& length,
+                    uint32_t* kind = nullptr) const;
+    bool putSlot(const prsr::Hash128& key, uint64_t offset);
+    bool findSlot(const prsr::Hash128& key, uint64_t& offset) const;
+
+    std::string path;
+    std::unique_ptr<MappedFile> file;
+    mutable std::mutex mutex;
+    size_t entryCount = 0;
+    long long hits = 0;
+    long long misses = 0;
+    long long appends = 0;
+    mutable long long rejected = 0;
+};
+
+// Спільний кеш процесу
+ResultCache& resultCache();
+
+// Виправлення, дерево і плани для кожного procCount — з кешу або обчислені й додані до нього
+std::shared_ptr<const CachedResult> analyzeExpression(const std::string& expr, const std::vector<int>& procCounts,
+                                                      ResultCache& cache = resultCache());
+void printCacheStats(const CacheStats& stats);
+void printPersistentStats(const PersistentStats& stats);
+
+// Компактне двійкове подання запису кешу для журналу на диску. decode не будує дерево
+// і призначення планів — їх розгортає CachedResult::materialize при першому зверненні.
+std::string encodeCachedResult(const CachedResult& value);
+std::shared_ptr<CachedResult> decodeCachedResult(const char* data, size_t size);
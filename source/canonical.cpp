@@ -0,0 +1,149 @@
+#include "parser.h"
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+
+using namespace prsr;
+
+namespace {
+
+// Ключ для канонічного порядку: змінні раніше за складені операнди, далі — за текстом
+std::string orderKey(const Node* node) {
+    if (!node) return "2";
+    if (!node->isOperator) return "0" + node->value;
+    std::string key = "1" + node->value + "(";
+    for (size_t i = 0; i < node->children.size(); ++i) {
+        if (i) key += ",";
+        key += orderKey(node->children[i]);
+    }
+    return key + ")";
+}
+
+void sortOperands(std::vector<Node*>& operands) {
+    std::vector<std::pair<std::string, Node*>> keyed;
+    for (Node* n : operands) keyed.push_back({orderKey(n), n});
+    std::stable_sort(keyed.begin(), keyed.end(),
+                     [](const auto& x, const auto& y) { return x.first < y.first; });
+    for (size_t i = 0; i < keyed.size(); ++i) operands[i] = keyed[i].second;
+}
+
+Node* chain(const std::vector<Node*>& pos, const std::vector<Node*>& neg, const std::string& plus,
+            const std::string& minus) {
+    Node* acc = pos[0];
+    for (size_t i = 1; i < pos.size(); ++i) {
+        Node* next = new Node(plus, true, false, false);
+        next->children = {acc, pos[i]};
+        acc = next;
+    }
+    for (Node* term : neg) {
+        Node* next = new Node(minus, true, false, false);
+        next->children = {acc, term};
+        acc = next;
+    }
+    return acc;
+}
+
+// Згорнуті сталі записуються повністю: formatNumber лишає 6 знаків і змінив би значення
+Node* numberNode(double value) {
+    return new Node(formatExactNumber(value), false, true, false);
+}
+
+// Забирає числа з операндів
+void takeNumbers(std::vector<Node*>& operands, std::vector<double>& numbers) {
+    for (auto it = operands.begin(); it != operands.end();) {
+        if ((*it)->isNumber) {
+            numbers.push_back(std::stod((*it)->value));
+            delete *it;
+            it = operands.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace
+
+namespace prsr {
+
+// Канонічна форма ланцюжків + і *: усі сталі ланцюжка згортаються в одне число,
+// решта операндів сортується. 2+A+3+B+5 -> A+B+10, 2*A*3 -> 6*A, B*A/4*2 -> 0.5*A*B.
+Node* canonicalizeChains(Node* node) {
+    if (!node || !node->isOperator) return node;
+    bool additive = node->value == "+" || node->value == "-";
+    bool multiplicative = node->value == "*" || node->value == "/";
+    if (!additive && !multiplicative) {
+        for (auto& child : node->children) child = canonicalizeChains(child);
+        return node;
+    }
+    std::string plus = additive ? "+" : "*", minus = additive ? "-" : "/";
+    std::vector<Node*> pos, neg, inner;
+    bool hasNull = false;
+    collectSigned(node, plus, minus, true, pos, neg, inner, hasNull);
+    if (hasNull) {
+        for (auto& child : node->children) child = canonicalizeChains(child);
+        return node;
+    }
+    if (inner.empty()) {
+        // Вузол, який collectSigned не розбирає (напр. унарний мінус з -A+B), лишається як є
+        for (auto& child : node->children) child = canonicalizeChains(child);
+        return node;
+    }
+    for (Node* n : inner) {
+        n->children.clear();
+        delete n;
+    }
+    for (auto& t : pos) t = canonicalizeChains(t);
+    for (auto& t : neg) t = canonicalizeChains(t);
+
+    std::vector<double> posNumbers, negNumbers;
+    takeNumbers(pos, posNumbers);
+    double constant = additive ? 0.0 : 1.0;
+    for (double v : posNumbers) constant = additive ? constant + v : constant * v;
+    if (additive) {
+        takeNumbers(neg, negNumbers);
+        for (double v : negNumbers) constant -= v;
+    } else {
+        // Дільник згортається, лише якщо частка точна (A*2/4 -> 0.5*A, але A/3 лишається);
+        // ділення на нуль не згортаємо — його обробляє removeDivisionByZero
+        for (auto it = neg.begin(); it != neg.end();) {
+            double v = (*it)->isNumber ? std::stod((*it)->value) : 0.0;
+            double quotient = v != 0.0 ? constant / v : 0.0;
+            if (v != 0.0 && std::fma(quotient, v, -constant) == 0.0) {
+                constant = quotient;
+                delete *it;
+                it = neg.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    sortOperands(pos);
+    sortOperands(neg);
+
+    if (additive) {
+        if (constant > 0) pos.push_back(numberNode(constant));
+        else if (constant < 0) neg.push_back(numberNode(-constant));
+        if (pos.empty() && !neg.empty() && !neg[0]->isOperator && neg[0]->value[0] != '-') {
+            // -A-B: перший від'ємний листок стає від'ємним операндом без окремої операції
+            neg[0]->value = "-" + neg[0]->value;
+            pos.push_back(neg[0]);
+            neg.erase(neg.begin());
+        }
+        if (pos.empty()) pos.push_back(numberNode(0.0));
+    } else {
+        if (constant == 0.0) {
+            for (Node* t : pos) delete t;
+            for (Node* t : neg) delete t;
+            return numberNode(0.0);
+        }
+        if (constant == -1.0 && !pos.empty() && !pos[0]->isOperator && pos[0]->value[0] != '-') {
+            pos[0]->value = "-" + pos[0]->value;  // -1*A -> -A
+        } else if (constant != 1.0 || pos.empty()) {
+            pos.insert(pos.begin(), numberNode(constant));
+        }
+    }
+    return chain(pos, neg, plus, minus);
+}
+
+} // namespace prsr
@@ -0,0 +1,148 @@
+#include "parser.h"
+#include "modeling.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <functional>
+#include <algorithm>
+
+namespace {
+
+// Випадковий вираз з дужками: піддерева різної глибини і вартості
+std::string randomExpression(std::mt19937& rng, int depth) {
+    if (depth == 0 || rng() % 4 == 0) return std::string(1, (char)('A' + rng() % 8));
+    const char ops[] = {'+', '+', '*', '*', '-', '/'};
+    char op = ops[rng() % 6];
+    // Ланцюжки довші за 2 операнди — саме їх перебудовують балансування і перенесення знаків
+    int operands = 2 + (int)(rng() % 3);
+    std::string expr = "(";
+    std::string prev;
+    for (int i = 0; i < operands; ++i) {
+        std::string operand = randomExpression(rng, depth - 1);
+        // X-X і X/X спрощення згорнуло б у константу
+        while (operand == prev) operand = randomExpression(rng, depth - 1);
+        if (i > 0) expr += op;
+        expr += operand;
+        prev = operand;
+    }
+    return expr + ")";
+}
+
+// Вирази з ланцюжками нерівної вартості та ланцюжками віднімання і ділення
+const std::vector<std::string> kFixedCorpus = {
+    "A/B+C*D-E/F+G+H*A/B-C+D*E*F",
+    "A/B/C/D+E+F+G+H",
+    "A*B*C*D*E*F*G*H",
+    "A+B+C+D+E+F+G+H",
+    "(A/B/C)*D*E*F*G",
+    "A/B*C+D+E+F*G+H/C/D+E",
+    "(A+B)*(C+D)*E*F+G/H/A+B+C",
+    "A*B*C*D+E+F+G+H+A+B+C+D",
+    "(A-B)/(C-D)+E+F+G+H*A*B*C",
+    "A-B-C-D-E-F-G-H",
+    "A/B/C/D",
+    "A+B-C+D-E*F-G/H",
+    "A*B/C*D/E/F",
+    "A-(B-C)-D-(E+F)",
+};
+
+// Висота дерева в операціях
+int operatorHeight(prsr::Node* node) {
+    if (!node || !node->isOperator) return 0;
+    int h = 0;
+    for (auto* child : node->children) h = std::max(h, operatorHeight(child));
+    return h + 1;
+}
+
+int countOps(prsr::Node* node, const std::string& op) {
+    if (!node || !node->isOperator) return 0;
+    int n = node->value == op ? 1 : 0;
+    for (auto* child : node->children) n += countOps(child, op);
+    return n;
+}
+
+int scheduledMakespan(prsr::Node* tree, int procCount) {
+    int end = 0;
+    for (const auto& t : assignTasksWithDependencies(tree, procCount)) end = std::max(end, t.endTime);
+    return end;
+}
+
+} // namespace
+
+// Фіксовані вирази плюс випадкові з фіксованим зерном
+std::vector<std::string> benchmarkCorpus() {
+    std::vector<std::string> corpus = kFixedCorpus;
+    std::mt19937 rng(42);
+    for (int i = 0; i < 200; ++i) corpus.push_back(randomExpression(rng, 3));
+    return corpus;
+}
+
+// === Порівняння балансування за рівнями і за часом готовності операндів ===
+void prsr::benchmarkRebalancing(int procCount) {
+    std::vector<std::string> corpus = benchmarkCorpus();
+    long long pathBefore = 0, pathAfter = 0, spanBefore = 0, spanAfter = 0;
+    int improved = 0, worse = 0;
+    std::cout << "\n=== Rebalancing: level pairing vs earliest-ready pairing, " << procCount << " processors ===" << std::endl;
+    std::cout << "Critical path (levels -> ready) | makespan (levels -> ready) | expression" << std::endl;
+    // Дерева будуються без simplifyExpression, щоб порівняння стосувалося лише балансування
+    for (size_t i = 0; i < corpus.size(); ++i) {
+        prsr::Node* byLevels = prsr::balanceTreeByLevels(prsr::buildParseTree(corpus[i]));
+        prsr::Node* byReady = prsr::rebalanceChains(prsr::buildParseTree(corpus[i]));
+        int cpLevels = criticalPathLength(byLevels), cpReady = criticalPathLength(byReady);
+        int msLevels = scheduledMakespan(byLevels, procCount), msReady = scheduledMakespan(byReady, procCount);
+        pathBefore += cpLevels;
+        pathAfter += cpReady;
+        spanBefore += msLevels;
+        spanAfter += msReady;
+        if (cpReady < cpLevels) improved++;
+        if (cpReady > cpLevels) worse++;
+        if (i < kFixedCorpus.size()) {
+            std::cout << std::setw(14) << cpLevels << " -> " << std::setw(3) << cpReady
+                      << "    | " << std::setw(11) << msLevels << " -> " << std::setw(3) << msReady
+                      << "          | " << corpus[i] << std::endl;
+        }
+        delete byLevels;
+        delete byReady;
+    }
+    std::cout << "Corpus: " << corpus.size() << " expressions, critical path shorter in " << improved
+              << ", longer in " << worse << std::endl;
+    std::cout << "Total critical path: " << pathBefore << " -> " << pathAfter;
+    if (pathBefore > 0) std::cout << " (" << 100.0 * (pathBefore - pathAfter) / pathBefore << "% shorter)";
+    std::cout << std::endl;
+    std::cout << "Total makespan on " << procCount << " processors: " << spanBefore << " -> " << spanAfter << std::endl;
+}
+
+// === Перенесення знаків: a-b-c-d -> a-(b+c+d), a/b/c/d -> a/(b*c*d) перед балансуванням ===
+void prsr::benchmarkSignPropagation(int procCount) {
+    std::vector<std::string> corpus = benchmarkCorpus();
+    long long heightBefore = 0, heightAfter = 0, divBefore = 0, divAfter = 0, spanBefore = 0, spanAfter = 0;
+    std::cout << "\n=== Sign propagation before balancing, " << procCount << " processors ===" << std::endl;
+    std::cout << "Height | divisions | makespan | expression" << std::endl;
+    for (size_t i = 0; i < corpus.size(); ++i) {
+        prsr::Node* plain = prsr::rebalanceChains(prsr::buildParseTree(corpus[i]));
+        prsr::Node* signs = prsr::optimizeParallelTree(prsr::buildParseTree(corpus[i]));
+        int h0 = operatorHeight(plain), h1 = operatorHeight(signs);
+        int d0 = countOps(plain, "/"), d1 = countOps(signs, "/");
+        int m0 = scheduledMakespan(plain, procCount), m1 = scheduledMakespan(signs, procCount);
+        heightBefore += h0;
+        heightAfter += h1;
+        divBefore += d0;
+        divAfter += d1;
+        spanBefore += m0;
+        spanAfter += m1;
+        if (i < kFixedCorpus.size()) {
+            std::cout << std::setw(2) << h0 << "->" << std::setw(2) << h1
+                      << " | " << std::setw(3) << d0 << " -> " << std::setw(2) << d1
+                      << " | " << std::setw(2) << m0 << " -> " << std::setw(2) << m1
+                      << " | " << corpus[i] << std::endl;
+        }
+        delete plain;
+        delete signs;
+    }
+    std::cout << "Corpus: " << corpus.size() << " expressions" << std::endl;
+    std::cout << "Total height: " << heightBefore << " -> " << heightAfter << std::endl;
+    std::cout << "Total divisions: " << divBefore << " -> " << divAfter << std::endl;
+    std::cout << "Total makespan on " << procCount << " processors: " << spanBefore << " -> " << spanAfter << std::endl;
+}
@@ -0,0 +1,642 @@
+#include "cache.h"
+#include "serialize.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Формат файлу: усі поля в порядку байтів машини, записи вирівняні на 8 байт
+const char kMagic[8] = {'C', 'S', 'S', 'W', 'R', 'C', '0', '1'};
+const uint32_t kFormatVersion = 4;  // 3: ключі з хешем чисел за бітами double; 4: записи-псевдоніми
+const uint64_t kInitialLogBytes = 1u << 20;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t slotCount;   // степінь двійки
+    uint64_t logStart;
+    uint64_t logEnd;      // межа підтверджених записів; усе далі — недописане
+};
+
+// Порожня комірка — нульовий ключ (hashTree ніколи не повертає нуль).
+// offset пишеться раніше за ключ і змінюється одним вирівняним 8-байтовим записом.
+struct Slot {
+    uint64_t hi;
+    uint64_t lo;
+    uint64_t offset;
+};
+
+// Вид запису: результат (encodeCachedResult) або псевдонім — 16 байт ключа результату
+const uint32_t kResultRecord = 0;
+const uint32_t kAliasRecord = 1;
+
+struct RecordHeader {
+    uint64_t hi;
+    uint64_t lo;
+    uint32_t length;
+    uint32_t checksum;
+    uint32_t kind;
+    uint32_t reserved;
+};
+
+uint32_t checksum32(const char* data, size_t size) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        h ^= (unsigned char)data[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+uint64_t align8(uint64_t n) { return (n + 7) & ~7ull; }
+
+uint64_t recordBytes(uint32_t length) { return align8(sizeof(RecordHeader) + length); }
+
+uint64_t logStartFor(uint64_t slotCount) {
+    return (sizeof(FileHeader) + slotCount * sizeof(Slot) + 63) & ~63ull;
+}
+
+uint64_t roundSlots(size_t slots) {
+    uint64_t n = 64;
+    while (n < slots) n <<= 1;
+    return n;
+}
+
+// === Двійкове кодування запису ===
+class Writer {
+public:
+    template <typename T>
+    void put(T value) { out.append(reinterpret_cast<const char*>(&value), sizeof(T)); }
+    void putString(const std::string& s) {
+        put<uint32_t>((uint32_t)s.size());
+        out += s;
+    }
+    std::string out;
+};
+
+class Reader {
+public:
+    Reader(const char* data, size_t size) : data(data), size(size) {}
+    template <typename T>
+    bool get(T& value) {
+        if (size - pos < sizeof(T)) return false;
+        std::memcpy(&value, data + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+    bool getView(std::string_view& s) {
+        uint32_t length = 0;
+        if (!get(length) || size - pos < length) return false;
+        s = std::string_view(data + pos, length);
+        pos += length;
+        return true;
+    }
+    bool getString(std::string& s) {
+        std::string_view view;
+        if (!getView(view)) return false;
+        s.assign(view);
+        return true;
+    }
+    bool done() const { return pos == size; }
+
+private:
+    const char* data;
+    size_t size;
+    size_t pos = 0;
+};
+
+} // namespace
+
+// Дерево і плани — у форматах serializeTree і serializeSchedule, кожен із префіксом довжини
+std::string encodeCachedResult(const CachedResult& value) {
+    Writer w;
+    w.putString(value.corrected);
+    w.put<uint8_t>(value.valid ? 1 : 0);
+    w.put<double>(value.computeSeconds);
+    w.putString(serializeTree(value.tree));
+    w.put<uint32_t>((uint32_t)value.schedules.size());
+    for (const auto& s : value.schedules) {
+        w.put<int32_t>(s.procCount);
+        w.put<int32_t>(s.seqTime);
+        w.put<int32_t>(s.makespan);
+        w.put<int32_t>(s.usedProcs);
+        w.putString(serializeSchedule(s.assignments));
+    }
+    return w.out;
+}
+
+// Читаються лише текст, прапорці й метрики планів; дерево і призначення пропускаються за
+// довжиною і лишаються в копії блоку до materialize. Копія потрібна, бо відображення
+// переїжджає, коли файл росте або ущільнюється.
+std::shared_ptr<CachedResult> decodeCachedResult(const char* data, size_t size) {
+    Reader r(data, size);
+    auto result = std::make_shared<CachedResult>();
+    uint8_t valid = 0;
+    uint32_t scheduleCount = 0;
+    std::string_view tree;
+    if (!r.getString(result->corrected) || !r.get(valid) || !r.get(result->computeSeconds) || !r.getView(tree) ||
+        !r.get(scheduleCount)) {
+        return nullptr;
+    }
+    result->valid = valid != 0;
+    for (uint32_t i = 0; i < scheduleCount; ++i) {
+        CachedSchedule s;
+        std::string_view plan;
+        if (!r.get(s.procCount) || !r.get(s.seqTime) || !r.get(s.makespan) || !r.get(s.usedProcs) || !r.getView(plan)) {
+            return nullptr;
+        }
+        result->schedules.push_back(std::move(s));
+    }
+    if (!r.done()) return nullptr;
+    result->encoded.assign(data, size);
+    return result;
+}
+
+// Вузли будуються через TreeView, призначення — через ScheduleView, один раз на запис
+void CachedResult::materialize() const {
+    std::call_once(decodeOnce, [this] {
+        if (!encoded.empty()) {
+            Reader r(encoded.data(), encoded.size());
+            std::string_view text, treeBytes, planBytes;
+            uint8_t flag = 0;
+            double seconds = 0.0;
+            uint32_t scheduleCount = 0;
+            bool ok = r.getView(text) && r.get(flag) && r.get(seconds) && r.getView(treeBytes) &&
+                      deserializeTree(treeBytes.data(), treeBytes.size(), tree) && r.get(scheduleCount) &&
+                      scheduleCount == schedules.size();
+            for (uint32_t i = 0; ok && i < scheduleCount; ++i) {
+                CachedSchedule& s = schedules[i];
+                ok = r.get(s.procCount) && r.get(s.seqTime) && r.get(s.makespan) && r.get(s.usedProcs) &&
+                     r.getView(planBytes) && deserializeSchedule(planBytes.data(), planBytes.size(), s.assignments);
+            }
+            if (ok) {
+                prsr::hashTree(tree);
+            } else {
+                // Контрольна сума вже збіглася, тож сюди потрапляє лише зіпсований формат
+                std::cout << "Error: a cache record cannot be decoded" << std::endl;
+                delete tree;
+                tree = nullptr;
+            }
+        }
+        decoded.store(true, std::memory_order_release);
+    });
+}
+
+// === Відображення файлу в пам'ять ===
+struct PersistentCache::MappedFile {
+#ifdef _WIN32
+    HANDLE handle = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+    char* base = nullptr;
+    uint64_t size = 0;
+
+    ~MappedFile() { close(); }
+
+    bool open(const std::string& path) {
+#ifdef _WIN32
+        handle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS,
+                             FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER length;
+        if (!GetFileSizeEx(handle, &length)) return false;
+        return length.QuadPart == 0 || map((uint64_t)length.QuadPart);
+#else
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) return false;
+        return st.st_size == 0 || map((uint64_t)st.st_size);
+#endif
+    }
+
+    // Розширює файл і відображає його заново; адреса base може змінитися
+    bool resize(uint64_t newSize) {
+        unmap();
+#ifdef _WIN32
+        // CreateFileMapping сам подовжує файл до розміру відображення
+        return map(newSize);
+#else
+        if (ftruncate(fd, (off_t)newSize) != 0) return false;
+        return map(newSize);
+#endif
+    }
+
+    bool map(uint64_t newSize) {
+#ifdef _WIN32
+        mapping = CreateFileMappingA(handle, nullptr, PAGE_READWRITE, (DWORD)(newSize >> 32), (DWORD)newSize, nullptr);
+        if (!mapping) return false;
+        base = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, (SIZE_T)newSize));
+        if (!base) return false;
+#else
+        void* p = mmap(nullptr, (size_t)newSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) return false;
+        base = static_cast<char*>(p);
+#endif
+        size = newSize;
+        return true;
+    }
+
+    void flush(uint64_t offset, uint64_t length) {
+        if (!base || length == 0) return;
+#ifdef _WIN32
+        FlushViewOfFile(base + offset, (SIZE_T)length);
+        FlushFileBuffers(handle);
+#else
+        uint64_t page = (uint64_t)sysconf(_SC_PAGESIZE);
+        uint64_t start = offset / page * page;
+        msync(base + start, (size_t)(offset + length - start), MS_SYNC);
+#endif
+    }
+
+    void unmap() {
+#ifdef _WIN32
+        if (base) UnmapViewOfFile(base);
+        if (mapping) CloseHandle(mapping);
+        mapping = nullptr;
+#else
+        if (base) munmap(base, (size_t)size);
+#endif
+        base = nullptr;
+        size = 0;
+    }
+
+    void close() {
+        unmap();
+#ifdef _WIN32
+        if (handle != INVALID_HANDLE_VALUE) CloseHandle(handle);
+        handle = INVALID_HANDLE_VALUE;
+#else
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+#endif
+    }
+
+    FileHeader* header() const { return reinterpret_cast<FileHeader*>(base); }
+    Slot* slots() const { return reinterpret_cast<Slot*>(base + sizeof(FileHeader)); }
+};
+
+PersistentCache::PersistentCache() = default;
+
+PersistentCache::~PersistentCache() { close(); }
+
+bool PersistentCache::isOpen() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return file != nullptr;
+}
+
+void PersistentCache::close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (file) file->flush(0, file->size);
+    file.reset();
+}
+
+bool PersistentCache::open(const std::string& filePath, size_t initialSlots) {
+    close();
+    std::lock_guard<std::mutex> lock(mutex);
+    auto mapped = std::make_unique<MappedFile>();
+    if (!mapped->open(filePath)) {
+        std::cout << "Error: cannot open cache file " << filePath << std::endl;
+        return false;
+    }
+    if (mapped->size == 0) {
+        uint64_t slotCount = roundSlots(initialSlots);
+        uint64_t logStart = logStartFor(slotCount);
+        if (!mapped->resize(logStart + kInitialLogBytes)) {
+            std::cout << "Error: cannot map cache file " << filePath << std::endl;
+            return false;
+        }
+        // Новий файл заповнений нулями: таблиця вже порожня
+        FileHeader* h = mapped->header();
+        h->version = kFormatVersion;
+        h->reserved = 0;
+        h->slotCount = slotCount;
+        h->logStart = logStart;
+        h->logEnd = logStart;
+        mapped->flush(0, logStart);
+        std::memcpy(h->magic, kMagic, sizeof(kMagic));
+        mapped->flush(0, sizeof(FileHeader));
+    }
+    const FileHeader* h = mapped->header();
+    bool sane = mapped->size >= sizeof(FileHeader) && std::memcmp(h->magic, kMagic, sizeof(kMagic)) == 0 &&
+                h->version == kFormatVersion && h->slotCount > 0 && (h->slotCount & (h->slotCount - 1)) == 0 &&
+                h->logStart == logStartFor(h->slotCount) && h->logStart <= h->logEnd && h->logEnd <= mapped->size;
+    if (!sane) {
+        std::cout << "Error: " << filePath << " is not a cache file of version " << kFormatVersion << std::endl;
+        return false;
+    }
+    path = filePath;
+    file = std::move(mapped);
+    entryCount = countEntries();
+    return true;
+}
+
+size_t PersistentCache::countEntries() const {
+    size_t entries = 0;
+    for (uint64_t i = 0; i < file->header()->slotCount; ++i) {
+        entries += file->slots()[i].hi != 0 || file->slots()[i].lo != 0;
+    }
+    return entries;
+}
+
+bool PersistentCache::remap(uint64_t newSize) {
+    if (file->resize(newSize)) return true;
+    std::cout << "Error: cannot grow cache file " << path << std::endl;
+    file.reset();
+    return false;
+}
+
+// Запис повністю потрапляє на диск раніше, ніж межа журналу його охоплює
+bool PersistentCache::appendRecord(const prsr::Hash128& key, uint32_t kind, const std::string& payload,
+                                   uint64_t& offset) {
+    offset = file->header()->logEnd;
+    uint64_t needed = recordBytes((uint32_t)payload.size());
+    if (offset + needed > file->size && !remap(std::max(file->size * 2, offset + needed))) return false;
+    RecordHeader record{key.hi, key.lo, (uint32_t)payload.size(), checksum32(payload.data(), payload.size()), kind, 0};
+    std::memcpy(file->base + offset, &record, sizeof(record));
+    std::memcpy(file->base + offset + sizeof(record), payload.data(), payload.size());
+    file->flush(offset, needed);
+    file->header()->logEnd = offset + needed;
+    file->flush(0, sizeof(FileHeader));
+    return true;
+}
+
+bool PersistentCache::readRecord(uint64_t offset, const prsr::Hash128& key, const char*& payload,
+                                 uint32_t& length, uint32_t* kind) const {
+    const FileHeader* h = file->header();
+    if (offset < h->logStart || offset % 8 != 0 || offset + sizeof(RecordHeader) > h->logEnd) return false;
+    RecordHeader record;
+    std::memcpy(&record, file->base + offset, sizeof(record));
+    if (record.hi != key.hi || record.lo != key.lo || offset + recordBytes(record.length) > h->logEnd) return false;
+    payload = file->base + offset + sizeof(RecordHeader);
+    length = record.length;
+    if (kind) *kind = record.kind;
+    return checksum32(payload, length) == record.checksum;
+}
+
+bool PersistentCache::putSlot(const prsr::Hash128& key, uint64_t offset) {
+    const uint64_t mask = file->header()->slotCount - 1;
+    for (uint64_t i = key.lo & mask, probes = 0; probes <= mask; i = (i + 1) & mask, ++probes) {
+        Slot& slot = file->slots()[i];
+        bool empty = slot.hi == 0 && slot.lo == 0;
+        if (!empty && (slot.hi != key.hi || slot.lo != key.lo)) continue;
+        slot.offset = offset;
+        if (empty) {
+            file->flush(sizeof(FileHeader) + i * sizeof(Slot), sizeof(Slot));
+            slot.lo = key.lo;
+            slot.hi = key.hi;
+            ++entryCount;
+        }
+        file->flush(sizeof(FileHeader) + i * sizeof(Slot), sizeof(Slot));
+        return true;
+    }
+    return false;
+}
+
+bool PersistentCache::findSlot(const prsr::Hash128& key, uint64_t& offset) const {
+    const uint64_t mask = file->header()->slotCount - 1;
+    for (uint64_t i = key.lo & mask, probes = 0; probes <= mask; i = (i + 1) & mask, ++probes) {
+        const Slot& slot = file->slots()[i];
+        if (slot.hi == 0 && slot.lo == 0) return false;
+        if (slot.hi != key.hi || slot.lo != key.lo) continue;
+        offset = slot.offset;
+        return true;
+    }
+    return false;
+}
+
+std::shared_ptr<const CachedResult> PersistentCache::find(const prsr::Hash128& key, bool countMiss) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file) return nullptr;
+    prsr::Hash128 target = key;
+    // Псевдонім веде прямо на запис результату, ланцюжків псевдонімів не буває
+    for (int hop = 0; hop < 2; ++hop) {
+        uint64_t offset = 0;
+        if (!findSlot(target, offset)) break;
+        const char* payload = nullptr;
+        uint32_t length = 0, kind = 0;
+        bool ok = readRecord(offset, target, payload, length, &kind);
+        if (ok && kind == kAliasRecord && hop == 0 && length == sizeof(target)) {
+            std::memcpy(&target.hi, payload, sizeof(target.hi));
+            std::memcpy(&target.lo, payload + sizeof(target.hi), sizeof(target.lo));
+            continue;
+        }
+        std::shared_ptr<CachedResult> result;
+        if (ok && kind == kResultRecord) result = decodeCachedResult(payload, length);
+        if (!result) {
+            ++rejected;
+            break;
+        }
+        ++hits;
+        return result;
+    }
+    if (countMiss) ++misses;
+    return nullptr;
+}
+
+bool PersistentCache::insert(const prsr::Hash128& key, const CachedResult& value) {
+    value.materialize();
+    std::string payload = encodeCachedResult(value);
+    std::lock_guard<std::mutex> lock(mutex);
+    return appendLocked(key, kResultRecord, payload);
+}
+
+bool PersistentCache::insertAlias(const prsr::Hash128& alias, const prsr::Hash128& key) {
+    std::string payload(sizeof(key.hi) + sizeof(key.lo), '\0');
+    std::memcpy(&payload[0], &key.hi, sizeof(key.hi));
+    std::memcpy(&payload[sizeof(key.hi)], &key.lo, sizeof(key.lo));
+    std::lock_guard<std::mutex> lock(mutex);
+    return appendLocked(alias, kAliasRecord, payload);
+}
+
+bool PersistentCache::appendLocked(const prsr::Hash128& key, uint32_t kind, const std::string& payload) {
+    if (!file) return false;
+    // Таблиця заповнена на 3/4 — ущільнення у вдвічі більшу
+    if ((entryCount + 1) * 4 > file->header()->slotCount * 3 && !compactLocked()) return false;
+    uint64_t offset = 0;
+    if (!appendRecord(key, kind, payload, offset) || !putSlot(key, offset)) return false;
+    ++appends;
+    return true;
+}
+
+// Живі записи копіюються без декодування в новий файл, який потім замінює старий
+bool PersistentCache::compact() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return compactLocked();
+}
+
+bool PersistentCache::compactLocked() {
+    if (!file) return false;
+    const FileHeader* h = file->header();
+    uint64_t live = 0;
+    size_t entries = 0;
+    for (uint64_t i = 0; i < h->slotCount; ++i) {
+        const Slot& slot = file->slots()[i];
+        if (slot.hi == 0 && slot.lo == 0) continue;
+        ++entries;
+        const char* payload = nullptr;
+        uint32_t length = 0;
+        if (readRecord(slot.offset, {slot.hi, slot.lo}, payload, length)) live += recordBytes(length);
+    }
+    uint64_t slotCount = roundSlots(std::max<size_t>(64, entries * 2 + 2));
+    std::string tmpPath = path + ".compact";
+    std::remove(tmpPath.c_str());
+    auto fresh = std::make_unique<MappedFile>();
+    if (!fresh->open(tmpPath) || !fresh->resize(logStartFor(slotCount) + std::max(live, kInitialLogBytes))) {
+        std::cout << "Error: cannot create " << tmpPath << std::endl;
+        return false;
+    }
+    FileHeader* out = fresh->header();
+    out->version = kFormatVersion;
+    out->slotCount = slotCount;
+    out->logStart = logStartFor(slotCount);
+    uint64_t end = out->logStart;
+    for (uint64_t i = 0; i < h->slotCount; ++i) {
+        const Slot& slot = file->slots()[i];
+        if (slot.hi == 0 && slot.lo == 0) continue;
+        const char* payload = nullptr;
+        uint32_t length = 0;
+        if (!readRecord(slot.offset, {slot.hi, slot.lo}, payload, length)) {
+            ++rejected;
+            continue;
+        }
+        uint64_t bytes = recordBytes(length);
+        std::memcpy(fresh->base + end, file->base + slot.offset, bytes);
+        for (uint64_t j = slot.lo & (slotCount - 1);; j = (j + 1) & (slotCount - 1)) {
+            Slot& target = fresh->slots()[j];
+            if (target.hi != 0 || target.lo != 0) continue;
+            target = {slot.hi, slot.lo, end};
+            break;
+        }
+        end += bytes;
+    }
+    out->logEnd = end;
+    fresh->flush(0, fresh->size);
+    std::memcpy(out->magic, kMagic, sizeof(kMagic));
+    fresh->flush(0, sizeof(FileHeader));
+    fresh.reset();
+    file.reset();
+    // Старий файл лишається цілим, доки новий не займе його місце
+#ifdef _WIN32
+    bool renamed = MoveFileExA(tmpPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    bool renamed = std::rename(tmpPath.c_str(), path.c_str()) == 0;
+#endif
+    if (!renamed) std::cout << "Error: cannot replace " << path << " with the compacted file" << std::endl;
+    auto reopened = std::make_unique<MappedFile>();
+    if (!reopened->open(path)) {
+        std::cout << "Error: cannot reopen cache file " << path << std::endl;
+        return false;
+    }
+    file = std::move(reopened);
+    entryCount = countEntries();
+    return renamed;
+}
+
+void PersistentCache::flush() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (file) file->flush(0, file->size);
+}
+
+PersistentStats PersistentCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    PersistentStats s;
+    s.hits = hits;
+    s.misses = misses;
+    s.appends = appends;
+    s.rejected = rejected;
+    if (!file) return s;
+    const FileHeader* h = file->header();
+    s.slots = (size_t)h->slotCount;
+    s.logBytes = h->logEnd - h->logStart;
+    s.fileBytes = file->size;
+    for (uint64_t i = 0; i < h->slotCount; ++i) {
+        const Slot& slot = file->slots()[i];
+        if (slot.hi == 0 && slot.lo == 0) continue;
+        ++s.entries;
+        const char* payload = nullptr;
+        uint32_t length = 0;
+        if (readRecord(slot.offset, {slot.hi, slot.lo}, payload, length)) s.liveBytes += recordBytes(length);
+    }
+    return s;
+}
+
+void printPersistentStats(const PersistentStats& stats) {
+    std::cout << "Disk cache: " << stats.entries << " / " << stats.slots << " slots, log " << std::fixed
+              << std::setprecision(1) << stats.logBytes / 1024.0 << " KiB (" << stats.liveBytes / 1024.0
+              << " KiB live), file " << stats.fileBytes / 1024.0 << " KiB, " << stats.hits << " hits, "
+              << stats.misses << " misses, " << stats.appends << " appends, " << stats.rejected << " rejected"
+              << std::defaultfloat << std::setprecision(6) << std::endl;
+}
+
+// === Теплий старт: ті самі вирази після «перезапуску» беруться з файлу ===
+void prsr::benchmarkWarmStart(const std::string& cachePath) {
+    // Шаблони зі зсунутими іменами змінних; benchmarkCorpus не підходить — він не проходить simplifyExpression
+    const std::vector<std::string> templates = {
+        "A/B+C*D-E/F+G+H*A/B-C+D*E*F", "A*B+A*C+A*D+E*F-E*G", "(A+B)*(C+D)*E*F+G/H/A+B+C",
+        "A+B+C+D+E+F+G+H", "A/B/C/D+E+F+G+H", "A*B*C*D*E*F*G*H", "(A-B)/(C-D)+E+F+G+H*A*B*C",
+    };
+    std::vector<std::string> corpus;
+    for (int shift = 0; shift < 18; ++shift) {
+        for (std::string expr : templates) {
+            for (char& c : expr) {
+                if (c >= 'A' && c <= 'Z') c = char('A' + (c - 'A' + shift) % 26);
+            }
+            corpus.push_back(expr);
+        }
+    }
+    const std::vector<int> procCounts = {1, 2, 5, 6, 8, 10};
+    std::remove(cachePath.c_str());
+    std::cout << "\n=== Disk cache warm start: " << corpus.size() << " expressions, " << cachePath << " ===" << std::endl;
+    for (const char* phase : {"cold", "warm"}) {
+        auto t0 = std::chrono::steady_clock::now();
+        PersistentCache store;
+        if (!store.open(cachePath)) return;
+        auto t1 = std::chrono::steady_clock::now();
+        // Новий ResultCache імітує перезапуск процесу: пам'ять порожня, файл — ні
+        ResultCache memory;
+        memory.attach(&store);
+        int valid = 0;
+        for (const auto& expr : corpus) valid += analyzeExpression(expr, procCounts, memory)->valid;
+        auto t2 = std::chrono::steady_clock::now();
+        std::cout << phase << ": open " << std::fixed << std::setprecision(3)
+                  << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms, analyze "
+                  << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms, " << valid << " valid"
+                  << std::defaultfloat << std::setprecision(6) << std::endl;
+        printPersistentStats(store.stats());
+    }
+    // Нова кількість процесорів дописує оновлені записи; старі стають сміттям до ущільнення
+    PersistentCache store;
+    if (!store.open(cachePath)) return;
+    ResultCache memory;
+    memory.attach(&store);
+    for (const auto& expr : corpus) analyzeExpression(expr, {3, 4}, memory);
+    std::cout << "after adding P = 3, 4:" << std::endl;
+    printPersistentStats(store.stats());
+    auto t0 = std::chrono::steady_clock::now();
+    store.compact();
+    std::cout << "after compaction (" << std::fixed << std::setprecision(3)
+              << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() << " ms):"
+              << std::defaultfloat << std::setprecision(6) << std::endl;
+    printPersistentStats(store.stats());
+    store.close();
+    std::remove(cachePath.c_str());
+}
@@ -0,0 +1,305 @@
+#include "parser.h"
+#include "modeling.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <map>
+#include <unordered_map>
+#include <tuple>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+
+using namespace prsr;
+
+namespace {
+
+// Вузол спільного DAG: однакові підвирази зберігаються один раз
+struct DagNode {
+    std::string value;
+    bool isOperator = false;
+    bool isNumber = false;
+    bool isVariable = false;
+    int a = -1;
+    int b = -1;
+    long long treeSize = 1;   // розмір після розгортання в дерево (насичується)
+    int work = 0;             // сума getOpDuration у дереві
+    int groupCount = 1;       // доданків (множників) у групі +/- (*) з коренем у цьому вузлі
+    int groupMaxPath = 0;     // найдовший критичний шлях серед них
+    int path = 0;             // оцінка критичного шляху після балансування групи
+};
+
+using DagKey = std::tuple<std::string, int, int, int>;
+
+constexpr long long kSizeCap = 1LL << 40;
+
+int log2Ceil(int n) {
+    int levels = 0;
+    while ((1 << levels) < n) ++levels;
+    return levels;
+}
+
+class TermDag {
+public:
+    int leaf(const std::string& value, bool isNumber, bool isVariable) {
+        DagNode n;
+        n.value = value;
+        n.isNumber = isNumber;
+        n.isVariable = isVariable;
+        return intern(n);
+    }
+
+    int number(double value) { return leaf(formatNumber(value), true, false); }
+
+    int op(const std::string& value, int a, int b) {
+        DagNode n;
+        n.value = value;
+        n.isOperator = true;
+        n.a = a;
+        n.b = b;
+        n.treeSize = std::min(kSizeCap, 1 + size(a) + size(b));
+        n.work = getOpDuration(value) + workOf(a) + workOf(b);
+        // Групи + і * оцінюються так, ніби їх уже збалансував rebalanceChains
+        bool additive = value == "+" || value == "-";
+        n.groupCount = 0;
+        n.groupMaxPath = 0;
+        for (int child : {a, b}) {
+            if (child < 0) continue;
+            const DagNode& c = nodes[child];
+            bool sameGroup = c.isOperator && (additive ? (c.value == "+" || c.value == "-") : (value == "*" && c.value == "*"));
+            if (sameGroup) {
+                n.groupCount += c.groupCount;
+                n.groupMaxPath = std::max(n.groupMaxPath, c.groupMaxPath);
+            } else {
+                n.groupCount += 1;
+                n.groupMaxPath = std::max(n.groupMaxPath, c.path);
+            }
+        }
+        if (additive || value == "*") {
+            n.path = n.groupMaxPath + log2Ceil(n.groupCount) * getOpDuration(value);
+        } else {
+            n.path = n.groupMaxPath + getOpDuration(value);
+        }
+        return intern(n);
+    }
+
+    int import(Node* node) {
+        if (!node) return -1;
+        if (!node->isOperator) return leaf(node->value, node->isNumber, node->isVariable);
+        std::vector<int> kids;
+        for (Node* child : node->children) kids.push_back(import(child));
+        if (kids.empty()) return leaf(node->value, false, false);
+        int acc = kids[0];
+        if (kids.size() == 1) return op(node->value, acc, -1);
+        for (size_t i = 1; i < kids.size(); ++i) acc = op(node->value, acc, kids[i]);
+        return acc;
+    }
+
+    Node* materialize(int id) const {
+        if (id < 0) return nullptr;
+        const DagNode& n = nodes[id];
+        Node* node = new Node(n.value, n.isOperator, n.isNumber, n.isVariable);
+        if (n.a >= 0 || n.b >= 0) {
+            node->children.push_back(materialize(n.a));
+            if (n.b >= 0) node->children.push_back(materialize(n.b));
+        }
+        return node;
+    }
+
+    // Доданки групи +/- з коефіцієнтами ±1 (ітеративно, без глибокої рекурсії)
+    void terms(int id, std::vector<std::pair<double, int>>& out) const {
+        std::vector<std::pair<int, double>> stack = {{id, 1.0}};
+        while (!stack.empty()) {
+            auto [c, sign] = stack.back();
+            stack.pop_back();
+            const DagNode& n = nodes[c];
+            if (n.isOperator && (n.value == "+" || n.value == "-") && n.a >= 0 && n.b >= 0) {
+                stack.push_back({n.b, n.value == "-" ? -sign : sign});
+                stack.push_back({n.a, sign});
+            } else {
+                out.push_back({sign, c});
+            }
+        }
+    }
+
+    const DagNode& at(int id) const { return nodes[id]; }
+    long long size(int id) const { return id < 0 ? 0 : nodes[id].treeSize; }
+    int workOf(int id) const { return id < 0 ? 0 : nodes[id].work; }
+    int pathOf(int id) const { return id < 0 ? 0 : nodes[id].path; }
+    size_t count() const { return nodes.size(); }
+
+private:
+    int intern(const DagNode& n) {
+        DagKey key{n.value, (n.isOperator ? 4 : 0) | (n.isNumber ? 2 : 0) | (n.isVariable ? 1 : 0), n.a, n.b};
+        auto it = memo.find(key);
+        if (it != memo.end()) return it->second;
+        int id = (int)nodes.size();
+        nodes.push_back(n);
+        memo.emplace(key, id);
+        return id;
+    }
+
+    std::vector<DagNode> nodes;
+    std::map<DagKey, int> memo;
+};
+
+class Distributor {
+public:
+    Distributor(TermDag& dag, const DistributiveLimits& limits, DistributiveReport& report)
+        : dag(dag), limits(limits), report(report), baseCount(dag.count()) {}
+
+    // Розгортання з пам'яттю: кожен спільний підвираз обробляється один раз
+    int expand(int id) {
+        if (id < 0) return id;
+        auto it = done.find(id);
+        if (it != done.end()) return it->second;
+        const DagNode n = dag.at(id);
+        int result = id;
+        if (n.isOperator) {
+            int a = expand(n.a), b = expand(n.b);
+            result = n.value == "*" && a >= 0 && b >= 0 ? distribute(a, b) : dag.op(n.value, a, b);
+        }
+        done.emplace(id, result);
+        return result;
+    }
+
+private:
+    int distribute(int a, int b) {
+        int plain = dag.op("*", a, b);
+        std::vector<std::pair<double, int>> left, right;
+        dag.terms(a, left);
+        dag.terms(b, right);
+        if (left.size() == 1 && right.size() == 1) return plain;
+        // Бюджет: оцінка розміру до побудови, нові вузли DAG і загальний приріст дерева
+        long long pairs = (long long)left.size() * (long long)right.size();
+        long long leftSize = 0, rightSize = 0;
+        for (const auto& l : left) leftSize = std::min(kSizeCap, leftSize + dag.size(l.second));
+        for (const auto& r : right) rightSize = std::min(kSizeCap, rightSize + dag.size(r.second));
+        // Кожна пара дає вузол *, копії обох множників і вузол суми
+        long long estimate = 2 * pairs - 1 + leftSize * (long long)right.size() + rightSize * (long long)left.size();
+        long long growth = estimate - dag.size(plain);
+        if (estimate > limits.maxNodes || growth + grown > limits.maxNodes ||
+            (long long)(dag.count() - baseCount) + 3 * pairs > limits.maxNodes) {
+            ++report.skippedBudget;
+            return plain;
+        }
+        // Однакові добутки (A*B і B*A) зливаються, протилежні — скорочуються
+        std::vector<int> order;
+        std::unordered_map<int, double> coef;
+        for (const auto& [cl, l] : left) {
+            for (const auto& [cr, r] : right) {
+                int product = dag.op("*", std::min(l, r), std::max(l, r));
+                auto found = coef.find(product);
+                if (found == coef.end()) {
+                    order.push_back(product);
+                    coef.emplace(product, cl * cr);
+                } else {
+                    found->second += cl * cr;
+                }
+            }
+        }
+        int expanded = sumOf(order, coef);
+        bool better = dag.pathOf(expanded) < dag.pathOf(plain) ||
+                      (dag.pathOf(expanded) == dag.pathOf(plain) && dag.workOf(expanded) < dag.workOf(plain));
+        if (limits.requireGain && !better) {
+            ++report.skippedNoGain;
+            return plain;
+        }
+        grown += std::max(0LL, dag.size(expanded) - dag.size(plain));
+        ++report.expanded;
+        return expanded;
+    }
+
+    int sumOf(const std::vector<int>& order, const std::unordered_map<int, double>& coef) {
+        std::vector<std::pair<double, int>> live;
+        for (int product : order) {
+            double c = coef.at(product);
+            if (c != 0.0) live.push_back({c, product});
+        }
+        if (live.empty()) return dag.number(0.0);
+        // Першим — додатний доданок
+        auto positive = std::find_if(live.begin(), live.end(), [](const auto& t) { return t.first > 0; });
+        if (positive != live.end()) std::rotate(live.begin(), positive, positive + 1);
+        auto term = [&](double c, int product) {
+            return std::fabs(c) == 1.0 ? product : dag.op("*", dag.number(std::fabs(c)), product);
+        };
+        int acc = term(live[0].first, live[0].second);
+        if (live[0].first < 0) acc = dag.op("*", dag.number(-1.0), acc);
+        for (size_t i = 1; i < live.size(); ++i) {
+            acc = dag.op(live[i].first < 0 ? "-" : "+", acc, term(live[i].first, live[i].second));
+        }
+        return acc;
+    }
+
+    TermDag& dag;
+    const DistributiveLimits& limits;
+    DistributiveReport& report;
+    size_t baseCount;
+    long long grown = 0;
+    std::unordered_map<int, int> done;
+};
+
+} // namespace
+
+namespace prsr {
+
+Node* applyDistributive(Node* node) {
+    return applyDistributive(node, DistributiveLimits());
+}
+
+// Розкриття дужок a*(b+c) -> a*b+a*c на спільному DAG: піддерева не копіюються, кожен
+// підвираз розгортається один раз, розмір результату обмежений limits.maxNodes
+Node* applyDistributive(Node* node, const DistributiveLimits& limits, DistributiveReport* report) {
+    DistributiveReport local;
+    DistributiveReport& stats = report ? *report : local;
+    if (!node) return nullptr;
+    TermDag dag;
+    int root = dag.import(node);
+    Distributor distributor(dag, limits, stats);
+    int expanded = distributor.expand(root);
+    stats.dagNodes = (int)dag.count();
+    if (stats.expanded == 0) return node;
+    delete node;
+    return dag.materialize(expanded);
+}
+
+// Розкриття (A+B)*(C+D)*...: час і розмір результату для наростаючої кількості множників
+void benchmarkDistributive() {
+    std::cout << "\n=== Distributive expansion, budget " << DistributiveLimits().maxNodes << " nodes ===" << std::endl;
+    std::cout << "Factors | mode      | expanded | budget stops | DAG nodes | result ops |  time, ms" << std::endl;
+    for (int factors : {2, 4, 8, 12, 16, 24}) {
+        std::string expr;
+        for (int i = 0; i < factors; ++i) {
+            if (i) expr += "*";
+            expr += std::string("(") + char('A' + (2 * i) % 26) + "+" + char('A' + (2 * i + 1) % 26) + ")";
+        }
+        for (bool requireGain : {false, true}) {
+            DistributiveLimits limits;
+            limits.requireGain = requireGain;
+            DistributiveReport report;
+            Node* tree = buildParseTree(expr);
+            auto t0 = std::chrono::steady_clock::now();
+            tree = applyDistributive(tree, limits, &report);
+            auto t1 = std::chrono::steady_clock::now();
+            int ops = 0;
+            std::vector<Node*> stack = {tree};
+            while (!stack.empty()) {
+                Node* n = stack.back();
+                stack.pop_back();
+                if (!n || !n->isOperator) continue;
+                ++ops;
+                for (Node* child : n->children) stack.push_back(child);
+            }
+            std::cout << std::setw(7) << factors << " | " << (requireGain ? "gain only" : "budget   ")
+                      << " | " << std::setw(8) << report.expanded << " | " << std::setw(12) << report.skippedBudget
+                      << " | " << std::setw(9) << report.dagNodes << " | " << std::setw(10) << ops << " | "
+                      << std::fixed << std::setprecision(2) << std::setw(9)
+                      << std::chrono::duration<double, std::milli>(t1 - t0).count()
+                      << std::defaultfloat << std::setprecision(6) << std::endl;
+            delete tree;
+        }
+    }
+}
+
+} // namespace prsr
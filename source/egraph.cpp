@@ -0,0 +1,379 @@
+#include "parser.h"
+#include "modeling.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <map>
+#include <set>
+#include <tuple>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+enum ENodeKind { KindOperator, KindVariable, KindNumber };
+
+// Вузол e-графа: оператор над класами еквівалентності або лист
+struct ENode {
+    std::string op;   // оператор або значення листа
+    int kind = KindOperator;
+    int a = -1;       // клас лівого операнда
+    int b = -1;       // клас правого операнда
+};
+
+using ENodeKey = std::tuple<std::string, int, int, int>;
+
+// E-граф з хеш-консингом і об'єднанням класів (union-find); конгруентність
+// відновлюється у rebuild після кожного раунду правил
+class EGraph {
+public:
+    int find(int c) {
+        while (parent[c] != c) {
+            parent[c] = parent[parent[c]];
+            c = parent[c];
+        }
+        return c;
+    }
+
+    int add(ENode n) {
+        if (n.a >= 0) n.a = find(n.a);
+        if (n.b >= 0) n.b = find(n.b);
+        ENodeKey key = keyOf(n);
+        auto it = memo.find(key);
+        if (it != memo.end()) return find(it->second);
+        int id = (int)parent.size();
+        parent.push_back(id);
+        classNodes.push_back({(int)nodes.size()});
+        nodeClass.push_back(id);
+        nodes.push_back(n);
+        memo.emplace(key, id);
+        return id;
+    }
+
+    int addOp(const std::string& op, int a, int b) {
+        ENode n;
+        n.op = op;
+        n.a = a;
+        n.b = b;
+        return add(n);
+    }
+
+    bool merge(int x, int y) {
+        x = find(x);
+        y = find(y);
+        if (x == y) return false;
+        if (classNodes[x].size() < classNodes[y].size()) std::swap(x, y);
+        parent[y] = x;
+        classNodes[x].insert(classNodes[x].end(), classNodes[y].begin(), classNodes[y].end());
+        classNodes[y].clear();
+        return true;
+    }
+
+    // Відновлення інваріантів: вузли з однаковими канонічними операндами — в одному класі
+    void rebuild() {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            memo.clear();
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                ENode& n = nodes[i];
+                if (n.a >= 0) n.a = find(n.a);
+                if (n.b >= 0) n.b = find(n.b);
+                ENodeKey key = keyOf(n);
+                auto it = memo.find(key);
+                if (it == memo.end()) {
+                    memo.emplace(key, find(nodeClass[i]));
+                } else if (merge(it->second, nodeClass[i])) {
+                    changed = true;
+                }
+            }
+        }
+        // Дублікати всередині класу більше не потрібні
+        for (size_t c = 0; c < classNodes.size(); ++c) {
+            if (find((int)c) != (int)c) continue;
+            std::set<ENodeKey> seen;
+            std::vector<int> unique;
+            for (int i : classNodes[c]) {
+                if (seen.insert(keyOf(nodes[i])).second) unique.push_back(i);
+            }
+            classNodes[c] = unique;
+        }
+    }
+
+    int addTree(prsr::Node* node) {
+        ENode n;
+        if (!node->isOperator) {
+            n.op = node->value;
+            n.kind = node->isNumber ? KindNumber : KindVariable;
+            return add(n);
+        }
+        // n-арні + і * розгортаються в бінарний ланцюжок
+        std::vector<int> operands;
+        for (auto* child : node->children) {
+            if (child) operands.push_back(addTree(child));
+        }
+        if (operands.empty()) {
+            n.op = node->value;
+            return add(n);
+        }
+        int acc = operands[0];
+        if (operands.size() == 1) return addOp(node->value, acc, -1);
+        for (size_t i = 1; i < operands.size(); ++i) acc = addOp(node->value, acc, operands[i]);
+        return acc;
+    }
+
+    std::vector<int> roots() {
+        std::vector<int> r;
+        for (size_t c = 0; c < parent.size(); ++c) {
+            if (find((int)c) == (int)c) r.push_back((int)c);
+        }
+        return r;
+    }
+
+    std::vector<int> nodesOf(int c) { return classNodes[find(c)]; }
+    const ENode& node(int i) const { return nodes[i]; }
+    size_t nodeCount() const { return nodes.size(); }
+
+private:
+    static ENodeKey keyOf(const ENode& n) { return {n.op, n.kind, n.a, n.b}; }
+
+    std::vector<ENode> nodes;
+    std::vector<int> nodeClass;
+    std::vector<int> parent;
+    std::vector<std::vector<int>> classNodes;
+    std::map<ENodeKey, int> memo;
+};
+
+// Один раунд правил: комутативність, асоціативність, дистрибутивність, винесення
+// спільного множника, перенесення знаків віднімання і ділення. Повертає кількість злиттів.
+int applyRules(EGraph& g, size_t maxNodes) {
+    int merges = 0;
+    for (int c : g.roots()) {
+        for (int idx : g.nodesOf(c)) {
+            if (g.nodeCount() > maxNodes) return merges;
+            ENode n = g.node(idx);
+            if (n.kind != KindOperator || n.a < 0 || n.b < 0) continue;
+            auto equate = [&](int other) {
+                if (g.merge(c, other)) ++merges;
+            };
+            auto each = [&](int cls, const char* op, const auto& fn) {
+                for (int m : g.nodesOf(cls)) {
+                    const ENode& e = g.node(m);
+                    if (e.kind == KindOperator && e.b >= 0 && e.op == op) fn(ENode(e));
+                }
+            };
+            const std::string& op = n.op;
+            if (op == "+" || op == "*") {
+                // a+b = b+a; (a+b)+c = a+(b+c)
+                equate(g.addOp(op, n.b, n.a));
+                each(n.a, op.c_str(), [&](const ENode& m) { equate(g.addOp(op, m.a, g.addOp(op, m.b, n.b))); });
+            }
+            if (op == "*") {
+                // a*(b±c) = a*b ± a*c; (a/b)*c = (a*c)/b
+                for (const char* sum : {"+", "-"}) {
+                    each(n.b, sum, [&](const ENode& m) {
+                        equate(g.addOp(sum, g.addOp("*", n.a, m.a), g.addOp("*", n.a, m.b)));
+                    });
+                    each(n.a, sum, [&](const ENode& m) {
+                        equate(g.addOp(sum, g.addOp("*", m.a, n.b), g.addOp("*", m.b, n.b)));
+                    });
+                }
+                each(n.a, "/", [&](const ENode& m) { equate(g.addOp("/", g.addOp("*", m.a, n.b), m.b)); });
+            }
+            if (op == "+" || op == "-") {
+                // a*b ± a*c = a*(b±c); a*c ± b*c = (a±b)*c
+                each(n.a, "*", [&](const ENode& l) {
+                    each(n.b, "*", [&](const ENode& r) {
+                        if (g.find(l.a) == g.find(r.a)) equate(g.addOp("*", l.a, g.addOp(op, l.b, r.b)));
+                        if (g.find(l.b) == g.find(r.b)) equate(g.addOp("*", g.addOp(op, l.a, r.a), l.b));
+                    });
+                });
+            }
+            if (op == "-") {
+                // (a-b)-c = a-(b+c); a-(b+c) = (a-b)-c; a-(b-c) = (a+c)-b; (a+b)-c = a+(b-c)
+                each(n.a, "-", [&](const ENode& m) { equate(g.addOp("-", m.a, g.addOp("+", m.b, n.b))); });
+                each(n.b, "+", [&](const ENode& m) { equate(g.addOp("-", g.addOp("-", n.a, m.a), m.b)); });
+                each(n.b, "-", [&](const ENode& m) { equate(g.addOp("-", g.addOp("+", n.a, m.b), m.a)); });
+                each(n.a, "+", [&](const ENode& m) { equate(g.addOp("+", m.a, g.addOp("-", m.b, n.b))); });
+            }
+            if (op == "+") {
+                // (a-b)+c = (a+c)-b
+                each(n.a, "-", [&](const ENode& m) { equate(g.addOp("-", g.addOp("+", m.a, n.b), m.b)); });
+            }
+            if (op == "/") {
+                // (a/b)/c = a/(b*c); a/(b*c) = (a/b)/c
+                each(n.a, "/", [&](const ENode& m) { equate(g.addOp("/", m.a, g.addOp("*", m.b, n.b))); });
+                each(n.b, "*", [&](const ENode& m) { equate(g.addOp("/", g.addOp("/", n.a, m.a), m.b)); });
+            }
+        }
+    }
+    return merges;
+}
+
+// Вибір вузла в кожному класі за вагою critical path + lambda * робота. Вага батька строго
+// більша за вагу дітей, тож вибрані вузли утворюють ациклічну структуру і дерево.
+struct Choice {
+    int node = -1;
+    int path = 0;
+    long long work = 0;
+    double score = 0.0;
+};
+
+prsr::Node* extractTree(EGraph& g, double lambda, int rootClass) {
+    std::map<int, Choice> best;
+    std::vector<int> classes = g.roots();
+    bool changed = true;
+    for (int pass = 0; changed && pass < 200; ++pass) {
+        changed = false;
+        for (int c : classes) {
+            for (int idx : g.nodesOf(c)) {
+                const ENode& n = g.node(idx);
+                Choice cand;
+                cand.node = idx;
+                if (n.kind == KindOperator) {
+                    int dur = getOpDuration(n.op);
+                    int path = 0;
+                    long long work = dur;
+                    bool ready = true;
+                    for (int child : {n.a, n.b}) {
+                        if (child < 0) continue;
+                        auto it = best.find(g.find(child));
+                        if (it == best.end()) {
+                            ready = false;
+                            break;
+                        }
+                        path = std::max(path, it->second.path);
+                        work += it->second.work;
+                    }
+                    if (!ready) continue;
+                    cand.path = path + dur;
+                    cand.work = work;
+                }
+                cand.score = cand.path + lambda * cand.work;
+                auto it = best.find(c);
+                if (it == best.end() || cand.score + 1e-9 < it->second.score) {
+                    best[c] = cand;
+                    changed = true;
+                }
+            }
+        }
+    }
+    std::function<prsr::Node*(int)> build = [&](int c) -> prsr::Node* {
+        auto it = best.find(g.find(c));
+        if (it == best.end()) return nullptr;
+        const ENode& n = g.node(it->second.node);
+        if (n.kind != KindOperator) return new prsr::Node(n.op, false, n.kind == KindNumber, n.kind == KindVariable);
+        prsr::Node* node = new prsr::Node(n.op, true, false, false);
+        if (n.a >= 0) node->children.push_back(build(n.a));
+        if (n.b >= 0) node->children.push_back(build(n.b));
+        return node;
+    };
+    return build(rootClass);
+}
+
+int modeledMakespan(prsr::Node* tree, int procCount) {
+    int end = 0;
+    for (const auto& t : assignTasksWithDependencies(tree, procCount)) end = std::max(end, t.endTime);
+    return end;
+}
+
+int operationCount(prsr::Node* node) {
+    if (!node || !node->isOperator) return 0;
+    int n = 1;
+    for (auto* child : node->children) n += operationCount(child);
+    return n;
+}
+
+} // namespace
+
+// Насичення рівностей у межах лімітів, потім вибір форми для кожного P: кандидати з різною
+// вагою роботи відносно критичного шляху оцінюються самим планувальником
+std::vector<prsr::Node*> optimizeWithEGraph(prsr::Node* root, const std::vector<int>& procCounts,
+                                            const EGraphLimits& limits, EGraphReport& report) {
+    std::vector<prsr::Node*> result(procCounts.size(), nullptr);
+    report = EGraphReport();
+    if (!root) return result;
+    auto t0 = std::chrono::steady_clock::now();
+    EGraph g;
+    int rootClass = g.addTree(root);
+    report.stopReason = "iteration limit";
+    for (int iter = 0; iter < limits.maxIterations; ++iter) {
+        int merges = applyRules(g, (size_t)limits.maxNodes);
+        g.rebuild();
+        report.iterations = iter + 1;
+        if (g.nodeCount() > (size_t)limits.maxNodes) {
+            report.stopReason = "node limit";
+            break;
+        }
+        if (merges == 0) {
+            report.stopReason = "saturated";
+            break;
+        }
+        if (std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count() > limits.maxSeconds) {
+            report.stopReason = "time limit";
+            break;
+        }
+    }
+    report.classes = (int)g.roots().size();
+    report.nodes = (int)g.nodeCount();
+
+    for (size_t i = 0; i < procCounts.size(); ++i) {
+        int procCount = std::max(1, procCounts[i]);
+        std::vector<prsr::Node*> candidates;
+        candidates.push_back(prsr::optimizeParallelTree(prsr::cloneSubtree(root)));
+        for (double weight : {0.0, 0.5, 1.0, 2.0, (double)procCount}) {
+            prsr::Node* tree = extractTree(g, weight / procCount, rootClass);
+            if (!tree) continue;
+            candidates.push_back(prsr::optimizeParallelTree(prsr::cloneSubtree(tree)));
+            candidates.push_back(tree);
+        }
+        report.candidates = (int)candidates.size();
+        int bestSpan = 0, bestOps = 0;
+        for (prsr::Node* tree : candidates) {
+            int span = modeledMakespan(tree, procCount), ops = operationCount(tree);
+            if (!result[i] || span < bestSpan || (span == bestSpan && ops < bestOps)) {
+                std::swap(result[i], tree);
+                bestSpan = span;
+                bestOps = ops;
+            }
+            delete tree;
+        }
+    }
+    return result;
+}
+
+// === Найкраща форма виразу для кожної кількості процесорів ===
+void prsr::optimizeForProcessors(const std::string& expr) {
+    if (!validateExpression(expr)) {
+        std::cout << "Error: the expression is not valid!" << std::endl;
+        return;
+    }
+    prsr::Node* tree = buildOptimizedTree(expr);
+    if (!tree) {
+        std::cout << "Error: failed to build the tree!" << std::endl;
+        return;
+    }
+    std::vector<int> procVariants = {1, 2, 4, 6, 8, 10};
+    EGraphLimits limits;
+    EGraphReport report;
+    std::vector<prsr::Node*> best = optimizeWithEGraph(tree, procVariants, limits, report);
+    prsr::Node* baseline = prsr::optimizeParallelTree(prsr::cloneSubtree(tree));
+
+    std::cout << "\n=== E-graph: " << report.classes << " classes, " << report.nodes << " nodes, "
+              << report.iterations << " iterations (" << report.stopReason << "), "
+              << report.candidates << " candidates per P ===" << std::endl;
+    std::cout << " P | optimizeParallelTree | e-graph | expression" << std::endl;
+    for (size_t i = 0; i < procVariants.size(); ++i) {
+        int p = procVariants[i];
+        std::cout << std::setw(2) << p << " | " << std::setw(11) << modeledMakespan(baseline, p)
+                  << " (" << std::setw(2) << operationCount(baseline) << " ops)"
+                  << " | " << std::setw(2) << modeledMakespan(best[i], p)
+                  << " (" << std::setw(2) << operationCount(best[i]) << " ops)"
+                  << " | " << treeToString(best[i]) << std::endl;
+        delete best[i];
+    }
+    delete baseline;
+    delete tree;
+}
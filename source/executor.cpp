@@ -0,0 +1,544 @@
+#include "parser.h"
+#include "modeling.h"
+#include "runtime.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <deque>
+#include <set>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <pthread.h>
+#endif
+
+// Прив'язка змінних: "A=1, B=2.5, C=-3"
+bool parseBindings(const std::string& text, std::map<std::string, double>& vars) {
+    std::stringstream items(text);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
+        if (item.empty()) continue;
+        size_t eq = item.find('=');
+        if (eq == std::string::npos || eq == 0) {
+            std::cout << "Error: invalid binding '" << item << "'" << std::endl;
+            return false;
+        }
+        try {
+            vars[item.substr(0, eq)] = std::stod(item.substr(eq + 1));
+        } catch (...) {
+            std::cout << "Error: invalid value in binding '" << item << "'" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+namespace {
+
+bool leafValue(prsr::Node* node, const std::map<std::string, double>& vars, double& value) {
+    if (node->isNumber) {
+        try {
+            value = std::stod(node->value);
+        } catch (...) {
+            std::cout << "Error: invalid number '" << node->value << "'" << std::endl;
+            return false;
+        }
+        return true;
+    }
+    // Змінна може нести унарний мінус після simplifyNegativeMultiplication ("-B")
+    bool negative = !node->value.empty() && node->value[0] == '-';
+    std::string name = negative ? node->value.substr(1) : node->value;
+    auto it = vars.find(name);
+    if (it == vars.end()) {
+        std::cout << "Error: variable '" << name << "' is not bound" << std::endl;
+        return false;
+    }
+    value = negative ? -it->second : it->second;
+    return true;
+}
+
+// Штучне навантаження, пропорційне тривалості операції в моделі
+double burn(int iterations) {
+    volatile double x = 1.0;
+    for (int i = 0; i < iterations; ++i) x = x * 1.0000001 + 1e-9;
+    return x;
+}
+
+double applyOp(char op, double a, double b) {
+    switch (op) {
+    case '+': return a + b;
+    case '-': return a - b;
+    case '*': return a * b;
+    case '/': return b == 0 ? 0 : a / b;  // як у evalSimpleExpr
+    }
+    return 0;
+}
+
+double evalTask(const ExecTask& task, const std::vector<double>& values, int spinPerUnit) {
+    if (spinPerUnit > 0) burn(spinPerUnit * getOpDuration(std::string(1, task.op)));
+    auto operand = [&](const ExecOperand& in) { return in.task >= 0 ? values[in.task] : in.value; };
+    double acc = operand(task.inputs[0]);
+    for (size_t i = 1; i < task.inputs.size(); ++i) acc = applyOp(task.op, acc, operand(task.inputs[i]));
+    return acc;
+}
+
+// Пул із крадіжкою роботи: у кожного потоку своя дека, готові задачі кладуться у свою,
+// а бездіяльний потік краде з протилежного кінця чужої. Викликаючий потік — робітник 0.
+class WorkStealingExecutor {
+public:
+    explicit WorkStealingExecutor(int threadCount) {
+        for (int i = 0; i < threadCount; ++i) workers.push_back(std::make_unique<Worker>());
+        for (int i = 1; i < threadCount; ++i) threads.emplace_back(&WorkStealingExecutor::helperLoop, this, i);
+    }
+
+    ~WorkStealingExecutor() {
+        {
+            std::lock_guard<std::mutex> lock(jobMutex);
+            stop = true;
+        }
+        jobCv.notify_all();
+        for (auto& t : threads) t.join();
+    }
+
+    double run(const ExecGraph& g, int spin) {
+        if (g.root < 0) return g.constant;
+        graph = &g;
+        spinPerUnit = spin;
+        size_t n = g.tasks.size();
+        if (values.size() != n) {
+            values.assign(n, 0.0);
+            pending = std::make_unique<std::atomic<int>[]>(n);
+        }
+        for (size_t i = 0; i < n; ++i) pending[i].store(g.tasks[i].pendingInputs, std::memory_order_relaxed);
+        remaining.store((int)n, std::memory_order_release);
+        size_t next = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if (g.tasks[i].pendingInputs != 0) continue;
+            Worker& w = *workers[next++ % workers.size()];
+            std::lock_guard<std::mutex> lock(w.m);
+            w.dq.push_back((int)i);
+        }
+        {
+            std::lock_guard<std::mutex> lock(jobMutex);
+            ++generation;
+        }
+        jobCv.notify_all();
+        work(0);
+        // Помічники мають вийти з задачі, перш ніж граф можна буде звільнити
+        while (active.load(std::memory_order_acquire) != 0) std::this_thread::yield();
+        return values[g.root];
+    }
+
+private:
+    struct Worker {
+        std::mutex m;
+        std::deque<int> dq;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    const ExecGraph* graph = nullptr;
+    int spinPerUnit = 0;
+    std::vector<double> values;
+    std::unique_ptr<std::atomic<int>[]> pending;
+    std::atomic<int> remaining{0};
+    std::atomic<int> active{0};
+    std::mutex jobMutex;
+    std::condition_variable jobCv;
+    unsigned long long generation = 0;
+    bool stop = false;
+
+    void helperLoop(int id) {
+        unsigned long long seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(jobMutex);
+                jobCv.wait(lock, [&] { return stop || generation != seen; });
+                if (stop) return;
+                seen = generation;
+                active.fetch_add(1, std::memory_order_acq_rel);
+            }
+            work(id);
+            active.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+    bool popOwn(int id, int& task) {
+        Worker& w = *workers[id];
+        std::lock_guard<std::mutex> lock(w.m);
+        if (w.dq.empty()) return false;
+        task = w.dq.back();
+        w.dq.pop_back();
+        return true;
+    }
+
+    bool steal(int id, int& task, std::minstd_rand& rng) {
+        size_t count = workers.size();
+        size_t first = rng() % count;
+        for (size_t k = 0; k < count; ++k) {
+            size_t victim = (first + k) % count;
+            if ((int)victim == id) continue;
+            Worker& w = *workers[victim];
+            std::lock_guard<std::mutex> lock(w.m);
+            if (w.dq.empty()) continue;
+            task = w.dq.front();
+            w.dq.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    void work(int id) {
+        std::minstd_rand rng(id + 1);
+        int task;
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            if (!popOwn(id, task) && !steal(id, task, rng)) {
+                std::this_thread::yield();
+                continue;
+            }
+            const ExecTask& t = graph->tasks[task];
+            values[task] = evalTask(t, values, spinPerUnit);
+            if (t.parent >= 0 && pending[t.parent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                Worker& w = *workers[id];
+                std::lock_guard<std::mutex> lock(w.m);
+                w.dq.push_back(t.parent);
+            }
+            remaining.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+};
+
+// Граф виконання у форматі рантайму: єдиний наступник операції — її батько
+RuntimeGraph toRuntimeGraph(const ExecGraph& graph) {
+    RuntimeGraph rg;
+    size_t n = graph.tasks.size();
+    rg.inDegree.resize(n);
+    rg.succStart.assign(n + 1, 0);
+    for (size_t i = 0; i < n; ++i) {
+        rg.inDegree[i] = graph.tasks[i].pendingInputs;
+        rg.succStart[i + 1] = rg.succStart[i] + (graph.tasks[i].parent >= 0 ? 1 : 0);
+        if (graph.tasks[i].parent >= 0) rg.succList.push_back(graph.tasks[i].parent);
+    }
+    return rg;
+}
+
+// Прив'язка потоку до ядра; процесорів моделі може бути більше, ніж ядер
+void pinThread(std::thread& thread, int cpu) {
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+#ifdef _WIN32
+    SetThreadAffinityMask(thread.native_handle(), (DWORD_PTR)1 << (cpu % hw));
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % hw, &set);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#else
+    (void)thread;
+    (void)cpu;
+#endif
+}
+
+// Очікування прапорця завершення: спершу коротке обертання, потім паркування без блокувань
+void waitFlag(const std::atomic<int>& flag) {
+    for (int i = 0; i < 2048; ++i) {
+        if (flag.load(std::memory_order_acquire)) return;
+    }
+    while (!flag.load(std::memory_order_acquire)) flag.wait(0, std::memory_order_acquire);
+}
+
+} // namespace
+
+// Граф виконання: оператори в пост-порядку, листи стають константами входів
+bool buildExecGraph(prsr::Node* root, const std::map<std::string, double>& vars, ExecGraph& graph) {
+    graph = ExecGraph();
+    if (!root) return false;
+    if (!root->isOperator) return leafValue(root, vars, graph.constant);
+    bool ok = true;
+    std::function<int(prsr::Node*)> visit = [&](prsr::Node* node) -> int {
+        ExecTask task{node->value.empty() ? '+' : node->value[0], -1, {}, 0};
+        for (auto* child : node->children) {
+            if (!child) continue;
+            if (child->isOperator) {
+                task.inputs.push_back({visit(child), 0.0});
+                task.pendingInputs++;
+            } else {
+                double v = 0.0;
+                if (!leafValue(child, vars, v)) ok = false;
+                task.inputs.push_back({-1, v});
+            }
+        }
+        int id = (int)graph.tasks.size();
+        for (const auto& in : task.inputs) {
+            if (in.task >= 0) graph.tasks[in.task].parent = id;
+        }
+        graph.tasks.push_back(task);
+        return id;
+    };
+    graph.root = visit(root);
+    return ok;
+}
+
+double evaluateSequential(const ExecGraph& graph, int spinPerUnit) {
+    if (graph.root < 0) return graph.constant;
+    std::vector<double> values(graph.tasks.size(), 0.0);
+    // Пост-порядок: входи кожної операції вже обчислені
+    for (size_t i = 0; i < graph.tasks.size(); ++i) values[i] = evalTask(graph.tasks[i], values, spinPerUnit);
+    return values[graph.root];
+}
+
+double executeWorkStealing(const ExecGraph& graph, int threads, int repeat, int spinPerUnit, double& seconds) {
+    WorkStealingExecutor executor(std::max(1, threads));
+    double result = executor.run(graph, spinPerUnit);  // прогрів
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeat; ++r) result = executor.run(graph, spinPerUnit);
+    auto t1 = std::chrono::steady_clock::now();
+    seconds = std::chrono::duration<double>(t1 - t0).count();
+    return result;
+}
+
+double executeParallel(const ExecGraph& graph, int threads, int repeat, int spinPerUnit, double& seconds) {
+    seconds = 0.0;
+    if (graph.root < 0) return graph.constant;
+    TaskRuntime runtime(std::max(1, threads));
+    RuntimeGraph rg = toRuntimeGraph(graph);
+    std::vector<double> values(graph.tasks.size(), 0.0);
+    std::function<void(int)> body = [&](int task) { values[task] = evalTask(graph.tasks[task], values, spinPerUnit); };
+    runtime.run(rg, body);  // прогрів
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeat; ++r) runtime.run(rg, body);
+    auto t1 = std::chrono::steady_clock::now();
+    seconds = std::chrono::duration<double>(t1 - t0).count();
+    return values[graph.root];
+}
+
+// Статичний розклад: один закріплений потік на процесор моделі, задачі — у запланованому порядку
+double executeStaticSchedule(const ExecGraph& graph, const std::vector<TaskAssignment>& plan, int procCount,
+                             int spinPerUnit, std::vector<SimTraceEntry>& timeline) {
+    timeline.clear();
+    if (graph.root < 0) return graph.constant;
+    size_t n = graph.tasks.size();
+    std::vector<std::vector<int>> order(procCount);
+    std::vector<TaskAssignment> sorted = plan;
+    std::stable_sort(sorted.begin(), sorted.end(), [](const TaskAssignment& a, const TaskAssignment& b) {
+        return a.startTime < b.startTime;
+    });
+    for (const auto& t : sorted) {
+        if (t.task >= 0 && t.task < (int)n && t.proc >= 0 && t.proc < procCount) order[t.proc].push_back(t.task);
+    }
+
+    std::vector<double> values(n, 0.0);
+    auto done = std::make_unique<std::atomic<int>[]>(n);
+    for (size_t i = 0; i < n; ++i) done[i].store(0, std::memory_order_relaxed);
+    std::vector<SimTraceEntry> measured(n, {-1, -1, 0.0, 0.0});
+    std::atomic<int> go{0};
+    std::chrono::steady_clock::time_point t0;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < procCount; ++p) {
+        threads.emplace_back([&, p] {
+            while (!go.load(std::memory_order_acquire)) go.wait(0, std::memory_order_acquire);
+            for (int task : order[p]) {
+                const ExecTask& t = graph.tasks[task];
+                for (const auto& in : t.inputs) {
+                    if (in.task >= 0) waitFlag(done[in.task]);
+                }
+                double start = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+                values[task] = evalTask(t, values, spinPerUnit);
+                double end = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+                measured[task] = {task, p, start, end};
+                done[task].store(1, std::memory_order_release);
+                done[task].notify_all();
+            }
+        });
+        pinThread(threads.back(), p);
+    }
+    t0 = std::chrono::steady_clock::now();
+    go.store(1, std::memory_order_release);
+    go.notify_all();
+    for (auto& t : threads) t.join();
+
+    for (const auto& m : measured) {
+        if (m.task >= 0) timeline.push_back(m);
+    }
+    return values[graph.root];
+}
+
+// Виміряна шкала накладається на модельну діаграму Ганта: час переводиться в одиниці моделі
+// за середнім масштабом (сумарний виміряний час / сумарна модельна тривалість)
+void printGanttOverlay(const ExecGraph& graph, const std::vector<TaskAssignment>& plan,
+                       const std::vector<SimTraceEntry>& timeline, int procCount) {
+    double modelWork = 0.0, realWork = 0.0, realEnd = 0.0;
+    int modelEnd = 0;
+    for (const auto& t : plan) {
+        modelWork += t.endTime - t.startTime;
+        modelEnd = std::max(modelEnd, t.endTime);
+    }
+    for (const auto& m : timeline) {
+        realWork += m.end - m.start;
+        realEnd = std::max(realEnd, m.end);
+    }
+    if (modelWork <= 0.0 || realWork <= 0.0) return;
+    double unit = realWork / modelWork;
+    std::cout << "1 model unit = " << unit * 1e6 << " us" << std::endl;
+    std::cout << "Makespan: model " << modelEnd << ", measured " << realEnd / unit
+              << " units (" << realEnd * 1e6 << " us)" << std::endl;
+
+    const int maxColumns = 120;
+    int columns = std::min(maxColumns, std::max(modelEnd, (int)std::ceil(realEnd / unit)));
+    std::vector<std::vector<std::string>> model(procCount, std::vector<std::string>(columns, "   "));
+    std::vector<std::vector<std::string>> real(procCount, std::vector<std::string>(columns, "   "));
+    for (const auto& t : plan) {
+        for (int c = t.startTime; c < t.endTime && c < columns; ++c) model[t.proc][c] = " " + t.op + " ";
+    }
+    for (const auto& m : timeline) {
+        int from = (int)std::floor(m.start / unit);
+        int to = std::max(from + 1, (int)std::ceil(m.end / unit));
+        std::string op(1, graph.tasks[m.task].op);
+        for (int c = from; c < to && c < columns; ++c) real[m.proc][c] = " " + op + " ";
+    }
+    std::cout << "          ";
+    for (int c = 0; c < columns; ++c) std::cout << "| " << c << " ";
+    std::cout << "|\n";
+    for (int p = 0; p < procCount; ++p) {
+        std::string label = "P" + std::to_string(p + 1);
+        label.resize(4, ' ');
+        std::cout << label << "model ";
+        for (int c = 0; c < columns; ++c) std::cout << "|" << model[p][c];
+        std::cout << "|\n" << label << "real  ";
+        for (int c = 0; c < columns; ++c) std::cout << "|" << real[p][c];
+        std::cout << "|\n";
+    }
+
+    // Де модельні тривалості розходяться з реальними
+    std::map<char, std::pair<double, int>> perOp;
+    for (const auto& m : timeline) {
+        auto& acc = perOp[graph.tasks[m.task].op];
+        acc.first += (m.end - m.start) / unit;
+        acc.second++;
+    }
+    std::cout << "Op | model units | measured units (avg)" << std::endl;
+    for (const auto& [op, acc] : perOp) {
+        std::cout << " " << op << " | " << std::setw(11) << getOpDuration(std::string(1, op))
+                  << " | " << acc.first / acc.second << std::endl;
+    }
+}
+
+// === Реальне паралельне виконання поряд з модельним прискоренням ===
+void prsr::executeSystem(const std::string& expr, const std::string& bindings) {
+    if (!validateExpression(expr)) {
+        std::cout << "Error: the expression is not valid!" << std::endl;
+        return;
+    }
+    std::map<std::string, double> vars;
+    if (!parseBindings(bindings, vars)) return;
+    prsr::Node* tree = buildOptimizedTree(expr);
+    tree = prsr::optimizeParallelTree(tree);
+    if (!tree) {
+        std::cout << "Error: failed to build the tree!" << std::endl;
+        return;
+    }
+    ExecGraph graph;
+    if (!buildExecGraph(tree, vars, graph)) {
+        delete tree;
+        return;
+    }
+    const int repeat = 2000;
+    const int spinPerUnit = 500;  // штучна робота на одиницю тривалості з getOpDuration
+    double expected = evaluateSequential(graph, 0);
+    std::cout << "\n=== Parallel execution (work stealing vs lock-free runtime), result = " << expected << " ===" << std::endl;
+
+    TaskGraph taskGraph = flattenTaskGraph(tree);
+    double totalWork = 0.0;
+    for (int d : taskGraph.duration) totalWork += d;
+
+    double stealingBase = 0.0, runtimeBase = 0.0;
+    std::vector<int> threadVariants = {1, 2, 5, 6, 8, 10};
+    std::vector<double> modeled, stealing, lockFree;
+    for (int threads : threadVariants) {
+        std::cout << "\n--- " << threads << " threads ---" << std::endl;
+        auto assignments = assignTasksWithDependencies(tree, threads);
+        int parTime = 0;
+        std::set<int> usedProcSet;
+        for (const auto& t : assignments) {
+            parTime = std::max(parTime, t.endTime);
+            usedProcSet.insert(t.proc);
+        }
+        modeled.push_back(parTime > 0 ? computeMetrics(totalWork, parTime, (int)usedProcSet.size(), threads) : 1.0);
+
+        double seconds = 0.0;
+        double value = executeWorkStealing(graph, threads, repeat, spinPerUnit, seconds);
+        if (threads == 1) stealingBase = seconds;
+        stealing.push_back(seconds > 0 ? stealingBase / seconds : 0.0);
+        if (value != expected) std::cout << "Warning: work-stealing result " << value << " differs from " << expected << std::endl;
+        value = executeParallel(graph, threads, repeat, spinPerUnit, seconds);
+        if (threads == 1) runtimeBase = seconds;
+        lockFree.push_back(seconds > 0 ? runtimeBase / seconds : 0.0);
+        if (value != expected) std::cout << "Warning: lock-free result " << value << " differs from " << expected << std::endl;
+    }
+
+    std::cout << "\nThreads | modeled speedup | work stealing | lock-free runtime" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < threadVariants.size(); ++i) {
+        std::cout << std::setw(7) << threadVariants[i] << " | " << std::setw(15) << modeled[i]
+                  << " | " << std::setw(13) << stealing[i] << " | " << std::setw(17) << lockFree[i] << std::endl;
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+    std::cout << "Hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    delete tree;
+}
+
+// === Виконання статичного плану assignTasksWithDependencies на закріплених потоках ===
+void prsr::executeStaticSystem(const std::string& expr, const std::string& bindings, int procCount) {
+    if (!validateExpression(expr)) {
+        std::cout << "Error: the expression is not valid!" << std::endl;
+        return;
+    }
+    std::map<std::string, double> vars;
+    if (!parseBindings(bindings, vars)) return;
+    prsr::Node* tree = buildOptimizedTree(expr);
+    tree = prsr::optimizeParallelTree(tree);
+    if (!tree) {
+        std::cout << "Error: failed to build the tree!" << std::endl;
+        return;
+    }
+    ExecGraph graph;
+    if (!buildExecGraph(tree, vars, graph)) {
+        delete tree;
+        return;
+    }
+    const int runs = 5;
+    const int spinPerUnit = 20000;
+    double expected = evaluateSequential(graph, 0);
+    auto plan = assignTasksWithDependencies(tree, procCount);
+    std::cout << "\n=== Static schedule on " << procCount << " pinned threads, result = " << expected << " ===" << std::endl;
+
+    // Найкоротший з кількох прогонів — найменше шуму від планувальника ОС
+    std::vector<SimTraceEntry> best, timeline;
+    double bestEnd = 0.0;
+    for (int r = 0; r < runs; ++r) {
+        double value = executeStaticSchedule(graph, plan, procCount, spinPerUnit, timeline);
+        if (value != expected) std::cout << "Warning: static result " << value << " differs from " << expected << std::endl;
+        double end = 0.0;
+        for (const auto& m : timeline) end = std::max(end, m.end);
+        if (r == 0 || end < bestEnd) {
+            bestEnd = end;
+            best = timeline;
+        }
+    }
+    printGanttOverlay(graph, plan, best, procCount);
+    delete tree;
+}
@@ -0,0 +1,157 @@
+#include "parser.h"
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstring>
+
+using namespace prsr;
+
+namespace {
+
+uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+// Дві незалежні половини: кожна — власне зерно і власне перемішування
+Hash128 mix128(const Hash128& h, uint64_t tag) {
+    Hash128 out;
+    out.hi = mix64(h.hi ^ mix64(h.lo + tag + 0x9e3779b97f4a7c15ull));
+    out.lo = mix64(h.lo ^ mix64(h.hi ^ (tag * 0xc2b2ae3d27d4eb4full)));
+    if (out.empty()) out.lo = 1;  // нуль зарезервовано для «не обчислено»
+    return out;
+}
+
+uint64_t stringHash(const std::string& s, uint64_t seed) {
+    uint64_t h = seed;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+Hash128 leafHash(const Node* node) {
+    Hash128 h;
+    if (node->isNumber) {
+        // Бітовий образ прочитаного double: 2 і 2.0 — одне число, 1.0000001 і 1.0000004 — різні
+        double value = std::stod(node->value);
+        if (value == 0.0) value = 0.0;  // -0 і 0
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        h.hi = mix64(bits ^ 1469598103934665603ull);
+        h.lo = mix64(bits ^ 0x84222325cbf29ce4ull);
+        return mix128(h, 1);
+    }
+    h.hi = stringHash(node->value, 1469598103934665603ull);
+    h.lo = stringHash(node->value, 0x84222325cbf29ce4ull);
+    return mix128(h, 2);
+}
+
+const Hash128 kNullHash = mix128(Hash128(), 3);
+
+enum GroupKind { NoGroup, Additive, Multiplicative };
+
+GroupKind groupOf(const Node* node) {
+    if (!node || !node->isOperator) return NoGroup;
+    if (node->value == "+" || node->value == "-") return Additive;
+    if (node->value == "*" || node->value == "/") return Multiplicative;
+    return NoGroup;
+}
+
+uint64_t opTag(const std::string& op) {
+    return stringHash(op, 0xcbf29ce484222325ull);
+}
+
+} // namespace
+
+namespace prsr {
+
+// Хеш обчислюється знизу вгору і записується в кожен вузол. Група +/- (або */÷) хешується як
+// мультимножина операндів зі знаками: внесок операнда додається або віднімається по половинах
+// (mod 2^64), тож порядок і розстановка дужок не впливають на результат, а вузол ланцюжка
+// успадковує суму дочірнього ланцюжка за O(1). Весь прохід — O(n) без рекурсії.
+Hash128 hashTree(Node* root) {
+    if (!root) return kNullHash;
+    std::unordered_map<const Node*, Hash128> groupSum;
+    std::vector<std::pair<Node*, bool>> stack = {{root, false}};
+    while (!stack.empty()) {
+        auto [node, visited] = stack.back();
+        stack.pop_back();
+        if (!node->isOperator) {
+            node->hash = leafHash(node);
+            continue;
+        }
+        if (!visited) {
+            stack.push_back({node, true});
+            for (Node* child : node->children) {
+                if (child) stack.push_back({child, false});
+            }
+            continue;
+        }
+        GroupKind kind = groupOf(node);
+        if (kind == NoGroup) {
+            Hash128 h;
+            h.hi = opTag(node->value);
+            h.lo = node->children.size();
+            for (Node* child : node->children) {
+                const Hash128& c = child ? child->hash : kNullHash;
+                h.hi += c.hi;
+                h.lo ^= c.lo;
+                h = mix128(h, 4);
+            }
+            node->hash = mix128(h, opTag(node->value));
+            continue;
+        }
+        bool inverse = node->value == "-" || node->value == "/";
+        Hash128 sum;
+        for (size_t i = 0; i < node->children.size(); ++i) {
+            Node* child = node->children[i];
+            Hash128 part;
+            if (groupOf(child) == kind) {
+                part = groupSum[child];
+                groupSum.erase(child);
+            } else {
+                part = mix128(child ? child->hash : kNullHash, 5);
+            }
+            if (inverse && i > 0) {
+                sum.hi -= part.hi;
+                sum.lo -= part.lo;
+            } else {
+                sum.hi += part.hi;
+                sum.lo += part.lo;
+            }
+        }
+        groupSum[node] = sum;
+        node->hash = mix128(sum, kind == Additive ? 6 : 7);
+    }
+    return root->hash;
+}
+
+Hash128 expressionHash(const std::string& expr) {
+    Node* tree = buildParseTree(expr);
+    Hash128 h = hashTree(tree);
+    delete tree;
+    return h;
+}
+
+// Без розбору: рядок хешується як є, окремий тег не дає збігтися зі структурними ключами
+Hash128 textHash(const std::string& text) {
+    Hash128 h;
+    h.hi = stringHash(text, 1469598103934665603ull);
+    h.lo = stringHash(text, 0x84222325cbf29ce4ull);
+    return mix128(h, 8);
+}
+
+// O(1), якщо обидва дерева вже мають хеш
+bool sameExpression(Node* a, Node* b) {
+    Hash128 ha = !a ? kNullHash : a->hash.empty() ? hashTree(a) : a->hash;
+    Hash128 hb = !b ? kNullHash : b->hash.empty() ? hashTree(b) : b->hash;
+    return ha == hb;
+}
+
+} // namespace prsr
@@ -1,5 +1,7 @@
 #include "gui.h"
 #include "parser.h"
+#include "cache.h"
+#include "runtime.h"
 #include <thread>
 #include <iostream>
 #include "../imgui/imgui.h"
@@ -40,6 +42,19 @@ void PrintTree(prsr::Node* node, int depth = 0) {
 
 bool showShapesWindow = false;
 
+// Machine description for heterogeneous modeling (see parseMachineSpec)
+char machineSpec[128] = "2x2.0, 4x1.0 /=12";
+// Functional-unit configuration (see parseResourceConfig)
+char unitSpec[128] = "2x ADD/SUB, 1x MUL:2:1, 1x DIV:4:2";
+// Variable values for real execution (see parseBindings)
+char arrivals[256] = "A=0, B=0, C=0, D=0, E=10, F=10, G=0, H=0";
+char bindings[256] = "A=1, B=2, C=3, D=4, E=5, F=6, G=7, H=8";
+// Processor counts for the sweep (see parseProcessorRange)
+char procRange[64] = "1..1024";
+// Persistent result cache file (see PersistentCache)
+char cachePath[256] = "cssw.cache";
+PersistentCache diskCache;
+
 prsr::Node* treeRoot = nullptr; // To store the parse tree root
 
 void ImGuiPrintTree(prsr::Node* node, int depth = 0) {
@@ -57,26 +72,6 @@ void ImGuiPrintTree(prsr::Node* node, int depth = 0) {
     ImGui::Unindent(depth * 20.0f);
 }
 
-std::string FullySimplifyAndCorrect(std::string expr) {
-    std::string prev;
-    int maxIterations = 40;
-    int iter = 0;
-    do {
-        prev = expr;
-        // 1. Simplify
-        expr = prsr::simplifyExpression(expr);
-        // 2. Check for errors
-        prsr::errors.clear();
-        prsr::checkExpression(expr.c_str());
-        // 3. If errors, correct
-        if (!prsr::errors.empty()) {
-            expr = prsr::correctExpression(&expr[0], prsr::errors);
-        }
-        iter++;
-    } while ((expr != prev || !prsr::errors.empty()) && iter < maxIterations);
-    return expr;
-}
-
 int main(int argc, char* argv[])
 {
     // Create gui
@@ -108,17 +103,137 @@ int main(int argc, char* argv[])
             ImGuiInputTextFlags_CharsUppercase |
             ImGuiInputTextFlags_CharsNoBlank);
         if (ImGui::Button("Auto-correct & Simplify")) {
+            // Текст виправляється завжди заново: кеш зберігає той запис виразу, що прийшов першим
+            // (B+A після A+B дав би A+B), тож з кешу беруться лише дерево і плани в "Model system"
             std::string input = prsr::expression;
             std::string result = FullySimplifyAndCorrect(input);
             prsr::simplifiedExpression = result;
+            std::lock_guard<std::mutex> lock(parserErrorsMutex);
             prsr::errors.clear();
             prsr::checkExpression(result.c_str());
         }
+        ImGui::SameLine();
+        if (ImGui::Button("Run pipeline")) {
+            // Кілька виразів через ';', кожен повторюється для вимірювання пропускної здатності
+            prsr::runExpressionPipeline(prsr::expression, 6, 100);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Model expression system")) {
+            // "X=A*B+C;Y=A*B-D": усі вирази — один граф зі спільними підвиразами
+            prsr::modelExpressionSystem(prsr::expression, 6);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Benchmark expression systems")) {
+            prsr::benchmarkExpressionSystem();
+        }
         if (ImGui::Button("Model system")) {
             prsr::modelSystem(prsr::simplifiedExpression, 6);
         }
+        ImGui::SameLine();
+        if (ImGui::Button("Simulate system")) {
+            prsr::simulateSystem(prsr::simplifiedExpression, 6);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Benchmark simulator")) {
+            prsr::benchmarkSimulator();
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Benchmark rebalancing")) {
+            prsr::benchmarkRebalancing(6);
+        }
+        // Бенчмарки перетворень дерева — окремим рядком
+        if (ImGui::Button("Benchmark sign propagation")) {
+            prsr::benchmarkSignPropagation(6);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Benchmark like terms")) {
+            prsr::benchmarkLikeTerms();
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Benchmark distributive")) {
+            prsr::benchmarkDistributive();
+        }
+        ImGui::InputText("Processors", procRange, IM_ARRAYSIZE(procRange));
+        if (ImGui::Button("Sweep processor counts")) {
+            // Аналіз дерева один раз, плани для всіх P — паралельно, до насичення makespan
+            prsr::sweepProcessorCounts(prsr::simplifiedExpression, procRange);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Benchmark processor sweep")) {
+            prsr::benchmarkProcessorSweep();
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Benchmark cache")) {
+            prsr::benchmarkResultCache();
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Cache stats")) {
+            printCacheStats(resultCache().stats());
+            if (diskCache.isOpen()) printPersistentStats(diskCache.stats());
+        }
+        ImGui::InputText("Cache file", cachePath, IM_ARRAYSIZE(cachePath));
+        if (ImGui::Button("Attach disk cache")) {
+            resultCache().attach(nullptr);
+            if (diskCache.open(cachePath)) resultCache().attach(&diskCache);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Compact disk cache")) {
+            if (diskCache.isOpen() && diskCache.compact()) printPersistentStats(diskCache.stats());
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Benchmark warm start")) {
+            prsr::benchmarkWarmStart(std::string(cachePath) + ".bench");
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Benchmark serialization")) {
+            prsr::benchmarkSerialization();
+        }
+        ImGui::InputText("Machine", machineSpec, IM_ARRAYSIZE(machineSpec));
+        if (ImGui::Button("Model heterogeneous (HEFT)")) {
+            prsr::modelHeterogeneousSystem(prsr::simplifiedExpression, machineSpec);
+        }
+        ImGui::InputText("Units", unitSpec, IM_ARRAYSIZE(unitSpec));
+        if (ImGui::Button("Model functional units")) {
+            prsr::modelFunctionalUnits(prsr::simplifiedExpression, unitSpec);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Model streaming (modulo)")) {
+            prsr::modelStreaming(prsr::simplifiedExpression, 6, unitSpec);
+        }
+        ImGui::InputText("Arrivals", arrivals, IM_ARRAYSIZE(arrivals));
+        if (ImGui::Button("Model input arrivals")) {
+            prsr::modelArrivals(prsr::simplifiedExpression, arrivals, 6);
+        }
+        if (ImGui::Button("Optimize per processor count (e-graph)")) {
+            prsr::optimizeForProcessors(prsr::simplifiedExpression);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Horner factoring")) {
+            prsr::modelFactoring(prsr::simplifiedExpression, 6);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Strength reduction")) {
+            prsr::modelStrengthReduction(prsr::simplifiedExpression, 6);
+        }
+        ImGui::InputText("Variables", bindings, IM_ARRAYSIZE(bindings));
+        if (ImGui::Button("Execute in parallel")) {
+            prsr::executeSystem(prsr::simplifiedExpression, bindings);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Execute static plan")) {
+            prsr::executeStaticSystem(prsr::simplifiedExpression, bindings, 6);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Benchmark runtime")) {
+            // Мільйон задач по одному додаванню: пропускна здатність рантайму без корисної роботи
+            unsigned hardware = std::thread::hardware_concurrency();  // std::max заважає макрос max з Windows.h
+            benchmarkRuntime(1 << 20, hardware > 0 ? (int)hardware : 1);
+        }
         ImGui::Text("Final expression: %s", prsr::simplifiedExpression.c_str());
-        prsr::displayErrors(prsr::errors);
+        {
+            std::lock_guard<std::mutex> lock(parserErrorsMutex);
+            prsr::displayErrors(prsr::errors);
+        }
 
         ImGui::Checkbox("Optimize expression", &showShapesWindow);
 
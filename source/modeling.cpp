@@ -1,4 +1,6 @@
 #include "parser.h"
+#include "modeling.h"
+#include "cache.h"
 #include <iostream>
 #include <vector>
 #include <string>
@@ -6,42 +8,49 @@
 #include <map>
 #include <set>
 #include <functional>
+#include <algorithm>
+#include <unordered_map>
+#include <mutex>
 
-struct TaskAssignment {
-    int proc;
-    int startTime;
-    int endTime;
-    std::string op;
-};
+std::mutex parserErrorsMutex;
 
-// 1. Перевірка валідності виразу
+// 1. Перевірка валідності виразу; помилки лишаються в prsr::errors для показу в GUI
 bool validateExpression(const std::string& expr) {
+    std::lock_guard<std::mutex> lock(parserErrorsMutex);
     prsr::errors.clear();
     prsr::checkExpression(expr.c_str());
     return prsr::errors.empty();
 }
 
+// Спрощення і виправлення по черзі, доки вираз не перестане змінюватися
+std::string FullySimplifyAndCorrect(std::string expr) {
+    std::lock_guard<std::mutex> lock(parserErrorsMutex);
+    std::string prev;
+    int maxIterations = 40;
+    int iter = 0;
+    do {
+        prev = expr;
+        // 1. Simplify
+        expr = prsr::simplifyExpression(expr);
+        // 2. Check for errors
+        prsr::errors.clear();
+        prsr::checkExpression(expr.c_str());
+        // 3. If errors, correct
+        if (!prsr::errors.empty()) {
+            expr = prsr::correctExpression(&expr[0], prsr::errors);
+        }
+        iter++;
+    } while ((expr != prev || !prsr::errors.empty()) && iter < maxIterations);
+    return expr;
+}
+
 // 2. Побудова дерева та оптимізація
 prsr::Node* buildOptimizedTree(const std::string& expr) {
     std::string simplified = prsr::simplifyExpression(expr);
-    return prsr::buildParseTree(simplified);
-}
-
-// 3. Побудова графу задачі (залишаємо лише оператори)
-prsr::Node* buildTaskGraph(prsr::Node* root) {
-    if (!root) return nullptr;
-    if (!root->isOperator) return nullptr; // Лист — не операція
-    prsr::Node* node = new prsr::Node(root->value, true, false, false);
-    for (auto* child : root->children) {
-        if (child->isOperator) {
-            prsr::Node* opChild = buildTaskGraph(child);
-            if (opChild) node->children.push_back(opChild);
-        } else {
-            // Додаємо "заглушку" для листа, щоб зберегти залежність
-            node->children.push_back(nullptr);
-        }
-    }
-    return node;
+    prsr::Node* tree = prsr::collectLikeTerms(prsr::buildParseTree(simplified));
+    tree = prsr::reduceStrength(prsr::canonicalizeChains(tree));
+    prsr::hashTree(tree);
+    return tree;
 }
 
 // 4. Групування операцій за рівнями (BFS)
@@ -62,6 +71,124 @@ std::vector<std::vector<prsr::Node*>> groupByLevels(prsr::Node* root) {
     return levels;
 }
 
+// 3. Граф задачі у формі CSR
+int TaskGraphBuilder::addTask(const std::string& op, std::vector<int> preds, int release) {
+    int id = (int)graph.opcode.size();
+    auto name = std::find(graph.opNames.begin(), graph.opNames.end(), op);
+    if (name == graph.opNames.end()) name = graph.opNames.insert(name, op);
+    graph.opcode.push_back((unsigned char)(name - graph.opNames.begin()));
+    graph.duration.push_back(getOpDuration(op));
+    graph.release.push_back(release);
+    // A*A зі спільним множником — одна залежність, а не дві
+    std::sort(preds.begin(), preds.end());
+    preds.erase(std::unique(preds.begin(), preds.end()), preds.end());
+    graph.inDegree.push_back((int)preds.size());
+    graph.predList.insert(graph.predList.end(), preds.begin(), preds.end());
+    graph.predStart.push_back((int)graph.predList.size());
+    return id;
+}
+
+// Наступники — обернені списки попередників (сортування підрахунком)
+TaskGraph TaskGraphBuilder::build() {
+    size_t n = graph.size();
+    graph.succStart.assign(n + 1, 0);
+    for (int p : graph.predList) graph.succStart[p + 1]++;
+    for (size_t i = 0; i < n; ++i) graph.succStart[i + 1] += graph.succStart[i];
+    graph.succList.assign(graph.predList.size(), 0);
+    std::vector<int> fill(graph.succStart.begin(), graph.succStart.end() - 1);
+    for (size_t i = 0; i < n; ++i) {
+        for (int p : graph.preds((int)i)) graph.succList[fill[p]++] = (int)i;
+    }
+    TaskGraph out = std::move(graph);
+    graph = TaskGraph();
+    return out;
+}
+
+// 3a. Плоский граф задачі: оператори в пост-порядку. Вузол, на який посилаються кілька
+// батьків (спільне піддерево), стає однією задачею з кількома споживачами.
+TaskGraph flattenTaskGraph(prsr::Node* root, const std::map<std::string, int>& arrival) {
+    TaskGraphBuilder builder;
+    std::unordered_map<const prsr::Node*, int> taskOf;
+    std::vector<std::pair<prsr::Node*, bool>> stack = {{root, false}};
+    while (!stack.empty()) {
+        auto [node, visited] = stack.back();
+        stack.pop_back();
+        if (!node || !node->isOperator || taskOf.count(node)) continue;
+        if (!visited) {
+            stack.push_back({node, true});
+            for (auto it = node->children.rbegin(); it != node->children.rend(); ++it) stack.push_back({*it, false});
+            continue;
+        }
+        std::vector<int> preds;
+        int release = 0;
+        for (auto* child : node->children) {
+            if (!child) continue;
+            if (child->isOperator) preds.push_back(taskOf.at(child));
+            else release = std::max(release, prsr::leafArrival(child, arrival));
+        }
+        taskOf[node] = builder.addTask(node->value, preds, release);
+    }
+    return builder.build();
+}
+
+// 3b. Критичний шлях дерева в тактах getOpDuration (необмежена кількість процесорів)
+int criticalPathLength(prsr::Node* root, const std::map<std::string, int>& arrival) {
+    if (!root) return 0;
+    if (!root->isOperator) return prsr::leafArrival(root, arrival);
+    int longest = 0;
+    for (auto* child : root->children) longest = std::max(longest, criticalPathLength(child, arrival));
+    return longest + getOpDuration(root->value);
+}
+
+// 3c. Дерево назад у рядок: дужки лише там, де їх вимагає пріоритет операцій
+std::string treeToString(prsr::Node* node) {
+    if (!node) return "";
+    if (!node->isOperator) return node->value;
+    auto precedence = [](const std::string& op) { return op == "*" || op == "/" ? 2 : 1; };
+    std::string out;
+    for (size_t i = 0; i < node->children.size(); ++i) {
+        prsr::Node* child = node->children[i];
+        std::string text = treeToString(child);
+        bool wrap = false;
+        if (child && child->isOperator) {
+            int pc = precedence(child->value), pn = precedence(node->value);
+            wrap = pc < pn || (pc == pn && i > 0 && (node->value == "-" || node->value == "/"));
+        } else if (i > 0 && !text.empty() && text[0] == '-') {
+            wrap = true;  // A-(-B), а не A--B
+        }
+        if (i > 0) out += node->value;
+        out += wrap ? "(" + text + ")" : text;
+    }
+    return out;
+}
+
+bool MachineModel::hasOverrides() const {
+    for (const auto& o : opOverride) {
+        if (!o.empty()) return true;
+    }
+    return false;
+}
+
+double MachineModel::procSpeed(int proc) const {
+    if (proc < 0 || proc >= (int)speed.size() || speed[proc] <= 0.0) return 1.0;
+    return speed[proc];
+}
+
+double MachineModel::opDuration(const std::string& op, int proc) const {
+    if (proc >= 0 && proc < (int)opOverride.size()) {
+        auto it = opOverride[proc].find(op);
+        if (it != opOverride[proc].end()) return it->second;
+    }
+    return getOpDuration(op) / procSpeed(proc);
+}
+
+MachineModel makeUniformMachine(int procCount) {
+    MachineModel machine;
+    machine.procCount = procCount;
+    machine.speed.assign(procCount, 1.0);
+    return machine;
+}
+
 // Функція для визначення тривалості операції
 int getOpDuration(const std::string& op) {
     if (op == "+" || op == "-") return 1;
@@ -70,55 +197,43 @@ int getOpDuration(const std::string& op) {
     return 1;
 }
 
-// Повністю готова функція: планування з урахуванням залежностей (без buildTaskGraph)
-std::vector<TaskAssignment> assignTasksWithDependencies(prsr::Node* root, int procCount) {
+// 5. Жадібне планування в порядку номерів задач: кожна задача — на процесор, який звільниться
+// найраніше, не раніше готовності її входів. Кожна задача DAG планується рівно один раз.
+std::vector<TaskAssignment> scheduleTaskGraph(const TaskGraph& graph, int procCount) {
     std::vector<TaskAssignment> assignments;
-    if (!root) return assignments;
-    std::vector<int> procAvailable(procCount, 0);
-    struct TaskInfo {
-        prsr::Node* node;
-        int start;
-        int end;
-        int proc;
-    };
-    std::vector<TaskInfo> taskInfos;
-    // DFS: для бінарних операторів (2 дитини)
-    std::function<int(prsr::Node*)> dfs = [&](prsr::Node* node) -> int {
-        if (!node) return 0;
-        if (!node->isOperator) return 0; // лист готовий одразу
-        int leftFinish = 0, rightFinish = 0;
-        if (node->children.size() > 0) leftFinish = dfs(node->children[0]);
-        if (node->children.size() > 1) rightFinish = dfs(node->children[1]);
-        int earliestStart = std::max(leftFinish, rightFinish);
+    std::vector<int> procAvailable(std::max(1, procCount), 0);
+    std::vector<int> finish(graph.size(), 0);
+    for (int task = 0; task < (int)graph.size(); ++task) {
+        int earliestStart = graph.release[task];
+        for (int p : graph.preds(task)) earliestStart = std::max(earliestStart, finish[p]);
         int minProc = 0;
         int minTime = std::max(procAvailable[0], earliestStart);
-        for (int i = 1; i < procCount; ++i) {
+        for (int i = 1; i < (int)procAvailable.size(); ++i) {
             int t = std::max(procAvailable[i], earliestStart);
             if (t < minTime) {
                 minTime = t;
                 minProc = i;
             }
         }
-        int duration = getOpDuration(node->value);
-        int start = std::max(procAvailable[minProc], earliestStart);
-        int end = start + duration;
-        taskInfos.push_back({node, start, end, minProc});
-        procAvailable[minProc] = end;
-        return end;
-    };
-    dfs(root);
-    std::sort(taskInfos.begin(), taskInfos.end(), [](const TaskInfo& a, const TaskInfo& b) {
-        return a.start < b.start;
-    });
-    for (const auto& t : taskInfos) {
-        assignments.push_back({t.proc, t.start, t.end, t.node->value});
+        finish[task] = minTime + graph.duration[task];
+        procAvailable[minProc] = finish[task];
+        assignments.push_back({minProc, minTime, finish[task], graph.op(task), task});
     }
+    std::sort(assignments.begin(), assignments.end(), [](const TaskAssignment& a, const TaskAssignment& b) {
+        return a.startTime < b.startTime;
+    });
     return assignments;
 }
 
+// Операція не може стартувати раніше, ніж надійдуть її змінні (arrival)
+std::vector<TaskAssignment> assignTasksWithDependencies(prsr::Node* root, int procCount,
+                                                        const std::map<std::string, int>& arrival) {
+    return scheduleTaskGraph(flattenTaskGraph(root, arrival), procCount);
+}
+
 // 6. Метрики
-void computeMetrics(int seqTime, int parTime, int usedProcs, int totalProcs) {
-    double speedup = (double)seqTime / parTime;
+double computeMetrics(double seqTime, double parTime, int usedProcs, int totalProcs) {
+    double speedup = seqTime / parTime;
     double effActive = speedup / usedProcs;
     double effTotal = speedup / totalProcs;
     std::cout << "Sequential computation time: " << seqTime << std::endl;
@@ -128,6 +243,7 @@ void computeMetrics(int seqTime, int parTime, int usedProcs, int totalProcs) {
     std::cout << "Total processors: " << totalProcs << std::endl;
     std::cout << "Efficiency (active): " << effActive << std::endl;
     std::cout << "Efficiency (total): " << effTotal << std::endl;
+    return speedup;
 }
 
 // 7. Візуалізація діаграми Ганта (текстова)
@@ -178,30 +294,21 @@ void prsr::modelSystem(const std::string& expr, int procCount) {
         std::cout << "Error: the expression is not valid!" << std::endl;
         return;
     }
-    // 2. Дерево
-    prsr::Node* tree = buildOptimizedTree(expr);
-    tree = prsr::optimizeParallelTree(tree);
-    if (!tree) {
+    // Масив кількостей процесорів для замірів
+    std::vector<int> procVariants = {1, 2, 5, 6, 8, 10};
+    // 2. Дерево і плани — з кешу результатів, якщо вираз уже аналізувався
+    auto analysis = analyzeExpression(expr, procVariants);
+    if (!analysis->valid) {
         std::cout << "Error: failed to build the tree!" << std::endl;
         return;
     }
-    // Масив кількостей процесорів для замірів
-    std::vector<int> procVariants = {1, 2, 5, 6, 8, 10};
     for (size_t i = 0; i < procVariants.size(); ++i) {
         int pCount = procVariants[i];
         std::cout << "\n=== Моделювання для " << pCount << " процесорів ===" << std::endl;
-        auto assignments = assignTasksWithDependencies(tree, pCount);
-        auto levels = groupByLevels(tree);
-        int seqTime = levels.size();
-        int parTime = assignments.empty() ? 0 : assignments.back().endTime;
-        std::set<int> usedProcSet;
-        for (const auto& t : assignments) usedProcSet.insert(t.proc);
-        int usedProcs = usedProcSet.size();
-        computeMetrics(seqTime, parTime, usedProcs, pCount);
+        const CachedSchedule* plan = analysis->schedule(pCount);
+        computeMetrics(plan->seqTime, plan->makespan, plan->usedProcs, pCount);
         if (i == procVariants.size() - 1) {
-            printGanttTable(assignments, pCount);
+            printGanttTable(plan->assignments, pCount);
         }
     }
-    // Clean up
-    if (tree) delete tree;
 }
@@ -0,0 +1,320 @@
+#pragma once
+
+#include "parser.h"
+#include <string>
+#include <vector>
+#include <functional>
+#include <map>
+#include <mutex>
+
+// Призначення операції на процесор у цілочисельних тактах
+struct TaskAssignment {
+    int proc;
+    int startTime;
+    int endTime;
+    std::string op;
+    int task = -1; // індекс задачі у TaskGraph (пост-порядок операторів)
+};
+
+// Діапазон індексів усередині масиву CSR
+struct TaskRange {
+    const int* first = nullptr;
+    const int* last = nullptr;
+
+    const int* begin() const { return first; }
+    const int* end() const { return last; }
+    size_t size() const { return (size_t)(last - first); }
+    bool empty() const { return first == last; }
+    int operator[](size_t i) const { return first[i]; }
+};
+
+// Плоский граф задачі у формі CSR: лише операції, ребра — залежності за даними. Задача
+// може мати кількох споживачів (спільні підвирази), тож це довільний DAG. Номери задач
+// топологічні: кожен попередник має менший номер, ніж задача.
+struct TaskGraph {
+    std::vector<std::string> opNames;   // таблиця кодів операцій
+    std::vector<unsigned char> opcode;
+    std::vector<int> duration;          // getOpDuration, такти
+    std::vector<int> inDegree;
+    std::vector<int> release;           // коли надходять змінні-операнди (arrival)
+    std::vector<int> predStart{0}, predList;
+    std::vector<int> succStart{0}, succList;
+
+    size_t size() const { return opcode.size(); }
+    const std::string& op(int task) const { return opNames[opcode[task]]; }
+    TaskRange preds(int task) const { return range(predStart, predList, task); }
+    TaskRange succs(int task) const { return range(succStart, succList, task); }
+
+private:
+    static TaskRange range(const std::vector<int>& start, const std::vector<int>& list, int task) {
+        const int* base = list.data();
+        return {base + start[task], base + start[task + 1]};
+    }
+};
+
+// Задачі додаються в топологічному порядку: усі preds уже мають бути додані
+class TaskGraphBuilder {
+public:
+    int addTask(const std::string& op, std::vector<int> preds, int release = 0);
+    TaskGraph build();
+
+private:
+    TaskGraph graph;
+};
+
+// Модель машини для симулятора
+struct MachineModel {
+    int procCount = 1;
+    std::vector<double> speed;  // множник швидкості процесора (порожньо — усі 1.0)
+    double commLatency = 0.0;   // затримка доставки результату на інший процесор
+    // Явна тривалість операції на конкретному процесорі (напр. немає апаратного ділення)
+    std::vector<std::map<std::string, double>> opOverride;
+
+    bool hasOverrides() const;
+    double procSpeed(int proc) const;
+    double opDuration(const std::string& op, int proc) const;
+};
+
+MachineModel makeUniformMachine(int procCount);
+MachineModel parseMachineSpec(const std::string& spec);
+double fastestSingleProcTime(const TaskGraph& graph, const MachineModel& machine);
+
+// Базові функції моделювання (modeling.cpp)
+bool validateExpression(const std::string& expr);
+prsr::Node* buildOptimizedTree(const std::string& expr);
+std::vector<std::vector<prsr::Node*>> groupByLevels(prsr::Node* root);
+int getOpDuration(const std::string& op);
+std::vector<TaskAssignment> assignTasksWithDependencies(prsr::Node* root, int procCount,
+                                                        const std::map<std::string, int>& arrival = {});
+double computeMetrics(double seqTime, double parTime, int usedProcs, int totalProcs);
+void printGantt(const std::vector<TaskAssignment>& assignments, int procCount);
+void printGanttTable(const std::vector<TaskAssignment>& assignments, int procCount);
+TaskGraph flattenTaskGraph(prsr::Node* root, const std::map<std::string, int>& arrival = {});
+std::vector<TaskAssignment> scheduleTaskGraph(const TaskGraph& graph, int procCount);
+int criticalPathLength(prsr::Node* root, const std::map<std::string, int>& arrival = {});
+std::string treeToString(prsr::Node* node);
+
+// checkExpression і correctExpression пишуть у глобальний prsr::errors — усі потоки, що їх
+// викликають, беруть цей м'ютекс
+extern std::mutex parserErrorsMutex;
+std::string FullySimplifyAndCorrect(std::string expr);
+
+// Еталонний набір виразів для порівняння оптимізацій (corpus.cpp)
+std::vector<std::string> benchmarkCorpus();
+
+// Час надходження вхідних змінних (arrival.cpp)
+bool parseArrivalTimes(const std::string& text, std::map<std::string, int>& arrival);
+
+// Дискретно-подійний симулятор (simulation.cpp)
+enum class SimEventType : unsigned char {
+    TaskFinish,
+    DataArrival
+};
+
+struct SimEvent {
+    double time;
+    unsigned long long seq;
+    int task;
+    int proc;
+    SimEventType type;
+};
+
+struct SimTraceEntry {
+    int task;
+    int proc;
+    double start;
+    double end;
+};
+
+struct SimResult {
+    std::vector<SimTraceEntry> trace;
+    std::vector<double> procBusy;
+    double makespan = 0.0;
+    double seqTime = 0.0;   // час на найшвидшому одиночному процесорі
+    int usedProcs = 0;
+    unsigned long long events = 0;
+};
+
+// Пріоритет готової задачі для динамічної політики (більший — раніше)
+using SimPriority = std::function<double(int task)>;
+
+std::vector<double> bottomLevels(const TaskGraph& graph, const MachineModel& machine);
+SimResult simulateSchedule(const TaskGraph& graph, const MachineModel& machine,
+                           const std::vector<TaskAssignment>& plan, bool keepTrace = true);
+SimResult simulatePolicy(const TaskGraph& graph, const MachineModel& machine,
+                         const SimPriority& priority, bool keepTrace = true);
+void printSimResult(const TaskGraph& graph, const SimResult& result, int procCount);
+std::vector<TaskAssignment> traceToPlan(const TaskGraph& graph, const std::vector<SimTraceEntry>& trace);
+
+// Гетерогенне планування (scheduling.cpp)
+std::vector<double> upwardRanks(const TaskGraph& graph, const MachineModel& machine);
+SimResult scheduleHEFT(const TaskGraph& graph, const MachineModel& machine);
+
+// Модель функціональних блоків (resources.cpp)
+struct UnitClass {
+    std::string name;              // напр. "ADD/SUB"
+    std::vector<std::string> ops;  // операції, які виконує блок
+    int count = 1;
+    int latency = 1;
+    int interval = 0;              // інтервал запуску (II); 0 — блок не конвеєризований
+
+    int issueInterval() const { return interval > 0 ? interval : latency; }
+};
+
+struct ResourceConfig {
+    std::vector<UnitClass> classes;
+
+    int classFor(const std::string& op) const;
+    int unitCount() const;
+};
+
+struct UnitClassReport {
+    int ops = 0;
+    int busy = 0;          // сумарна зайнятість блоків класу, такти
+    int lowerBound = 0;    // ceil(робота / кількість блоків)
+    double utilization = 0.0;
+};
+
+struct ResourceSchedule {
+    std::vector<TaskAssignment> assignments;  // proc — глобальний номер блока
+    std::vector<int> unitClass;               // клас кожного блока
+    std::vector<UnitClassReport> classes;
+    int makespan = 0;
+    int criticalPath = 0;
+    double throughput = 0.0;                  // операцій за такт
+    bool ok = true;
+};
+
+ResourceConfig parseResourceConfig(const std::string& spec);
+ResourceSchedule scheduleOnUnits(const TaskGraph& graph, const ResourceConfig& config);
+void printResourceSchedule(const ResourceConfig& config, const ResourceSchedule& schedule);
+ResourceConfig withoutPipelining(const ResourceConfig& config);
+
+// Модульне планування для потокового обчислення (modulo.cpp)
+struct ModuloSlot {
+    int task;
+    int time;    // час запуску в межах однієї ітерації
+    int stage;   // time / II
+    int unit;    // блок або процесор
+};
+
+struct ModuloSchedule {
+    int ii = 0;
+    int resMII = 0;
+    int recMII = 0;
+    int latency = 0;   // тривалість однієї ітерації
+    int stages = 0;
+    std::vector<ModuloSlot> slots;
+    std::vector<std::string> unitNames;
+    bool ok = false;
+
+    double throughput() const { return ii > 0 ? 1.0 / ii : 0.0; }
+};
+
+ModuloSchedule moduloScheduleProcessors(const TaskGraph& graph, int procCount);
+ModuloSchedule moduloScheduleUnits(const TaskGraph& graph, const ResourceConfig& config);
+void printModuloSchedule(const TaskGraph& graph, const ModuloSchedule& schedule);
+
+// Реальне виконання графа на потоках (executor.cpp)
+struct ExecOperand {
+    int task;      // вхід від іншої операції; -1 — константа
+    double value;
+};
+
+struct ExecTask {
+    char op;
+    int parent;    // -1 для кореня
+    std::vector<ExecOperand> inputs;
+    int pendingInputs;  // кількість входів від інших операцій
+};
+
+struct ExecGraph {
+    std::vector<ExecTask> tasks;  // той самий пост-порядок, що й у flattenTaskGraph
+    int root = -1;
+    double constant = 0.0;        // значення, якщо вираз — один лист
+};
+
+bool parseBindings(const std::string& text, std::map<std::string, double>& vars);
+bool buildExecGraph(prsr::Node* root, const std::map<std::string, double>& vars, ExecGraph& graph);
+double evaluateSequential(const ExecGraph& graph, int spinPerUnit);
+double executeWorkStealing(const ExecGraph& graph, int threads, int repeat, int spinPerUnit, double& seconds);
+double executeParallel(const ExecGraph& graph, int threads, int repeat, int spinPerUnit, double& seconds);
+// Виміряна часова шкала повертається як трасування (час у секундах від старту)
+double executeStaticSchedule(const ExecGraph& graph, const std::vector<TaskAssignment>& plan, int procCount,
+                             int spinPerUnit, std::vector<SimTraceEntry>& timeline);
+void printGanttOverlay(const ExecGraph& graph, const std::vector<TaskAssignment>& plan,
+                       const std::vector<SimTraceEntry>& timeline, int procCount);
+
+// Оптимізація насиченням рівностей на e-графі (egraph.cpp)
+struct EGraphLimits {
+    int maxNodes = 20000;
+    int maxIterations = 12;
+    double maxSeconds = 0.5;
+};
+
+struct EGraphReport {
+    int classes = 0;
+    int nodes = 0;
+    int iterations = 0;
+    std::string stopReason;   // saturated / node limit / time limit / iteration limit
+    int candidates = 0;       // дерев, оцінених планувальником для кожного P
+};
+
+// Для кожного procCounts[i] — окреме дерево з найменшим модельним makespan
+std::vector<prsr::Node*> optimizeWithEGraph(prsr::Node* root, const std::vector<int>& procCounts,
+                                            const EGraphLimits& limits, EGraphReport& report);
+
+// Система іменованих виразів в одному DAG зі спільними підвиразами (system.cpp)
+struct NamedExpression {
+    std::string name;
+    std::string expr;
+};
+
+struct SystemGraph {
+    TaskGraph graph;                  // пост-порядок: предки мають більші індекси
+    std::vector<std::string> names;
+    std::vector<std::string> corrected;
+    std::vector<int> outputs;         // задача, що обчислює вираз; -1 — вираз без операцій
+    int treeTasks = 0;                // операцій у всіх деревах до об'єднання
+    int sharedTasks = 0;              // задач, потрібних більш ніж одному виразу
+};
+
+struct SystemSchedule {
+    SimResult sim;
+    std::vector<double> completion;   // для кожного виразу: коли готовий результат
+    double separateMakespan = 0.0;    // ті самі вирази по черзі, кожен окремим графом
+    int staticMakespan = 0;           // scheduleTaskGraph на тому самому DAG
+};
+
+bool parseExpressionSystem(const std::string& text, std::vector<NamedExpression>& system);
+bool buildSystemGraph(const std::vector<NamedExpression>& system, SystemGraph& out);
+SystemSchedule scheduleSystem(const SystemGraph& system, int procCount);
+
+// Розгортка за кількістю процесорів (sweep.cpp)
+// Аналізи, що не залежать від P: рахуються один раз на всю розгортку
+struct SweepAnalysis {
+    TaskGraph graph;
+    int levels = 0;          // groupByLevels(tree).size() — seqTime у modelSystem
+    int totalWork = 0;       // сума тривалостей задач, такти
+    int criticalPath = 0;    // найдовший шлях з урахуванням release — нижня межа makespan
+};
+
+struct SweepPoint {
+    int procCount = 0;
+    int makespan = 0;
+    int usedProcs = 0;
+    bool computed = false;   // false — взято з точки насичення без планування
+    std::vector<TaskAssignment> assignments;
+};
+
+struct SweepResult {
+    std::vector<SweepPoint> points;   // за зростанням procCount
+    int saturatedAt = 0;              // найменше P, з якого план більше не змінюється; 0 — не досягнуто
+    int computed = 0;                 // скільки P справді спланували
+};
+
+SweepAnalysis analyzeForSweep(prsr::Node* tree);
+bool parseProcessorRange(const std::string& text, std::vector<int>& procCounts);
+// Зупинка лише там, де план для більших P гарантовано той самий; keepAssignments — зберегти плани
+SweepResult sweepProcessors(const SweepAnalysis& analysis, std::vector<int> procCounts, int threads,
+                            bool keepAssignments);
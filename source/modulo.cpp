@@ -0,0 +1,233 @@
+#include "parser.h"
+#include "modeling.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+// Задача модульного планування: клас ресурсу, латентність і зайнятість блока для кожної операції
+struct ModuloProblem {
+    std::vector<int> cls;
+    std::vector<int> lat;
+    std::vector<int> occ;
+    std::vector<int> classCount;
+    std::vector<std::string> className;
+};
+
+// Спроба розкласти одну ітерацію з інтервалом ii за модульною таблицею резервування (MRT)
+bool placeWithII(const TaskGraph& graph, const ModuloProblem& pb, const std::vector<int>& order,
+                 const std::vector<std::vector<int>>& classUnits, int ii, ModuloSchedule& ms) {
+    size_t n = graph.size();
+    std::vector<std::vector<char>> mrt(ms.unitNames.size(), std::vector<char>(ii, 0));
+    std::vector<int> start(n, -1), unit(n, -1);
+    for (int task : order) {
+        int est = 0;
+        for (int p : graph.preds(task)) est = std::max(est, start[p] + pb.lat[p]);
+        // Таблиця періодична, тож достатньо перевірити ii послідовних тактів
+        bool placed = false;
+        for (int t = est; t < est + ii && !placed; ++t) {
+            for (int u : classUnits[pb.cls[task]]) {
+                bool free = true;
+                for (int k = 0; k < pb.occ[task] && free; ++k) free = !mrt[u][(t + k) % ii];
+                if (!free) continue;
+                for (int k = 0; k < pb.occ[task]; ++k) mrt[u][(t + k) % ii] = 1;
+                start[task] = t;
+                unit[task] = u;
+                placed = true;
+                break;
+            }
+        }
+        if (!placed) return false;
+    }
+    ms.slots.clear();
+    ms.latency = 0;
+    ms.stages = 0;
+    for (size_t i = 0; i < n; ++i) {
+        ms.slots.push_back({(int)i, start[i], start[i] / ii, unit[i]});
+        ms.latency = std::max(ms.latency, start[i] + pb.lat[i]);
+        ms.stages = std::max(ms.stages, start[i] / ii + 1);
+    }
+    return true;
+}
+
+ModuloSchedule solveModulo(const TaskGraph& graph, const ModuloProblem& pb) {
+    ModuloSchedule ms;
+    size_t n = graph.size();
+    if (n == 0) return ms;
+
+    std::vector<std::vector<int>> classUnits(pb.classCount.size());
+    for (size_t c = 0; c < pb.classCount.size(); ++c) {
+        for (int k = 0; k < pb.classCount[c]; ++k) {
+            classUnits[c].push_back((int)ms.unitNames.size());
+            ms.unitNames.push_back(pb.className[c] + (pb.classCount[c] > 1 ? "#" + std::to_string(k + 1) : ""));
+        }
+    }
+
+    // ResMII: найзавантаженіший клас ресурсів; операція не може перекривати саму себе в таблиці
+    std::vector<long long> classWork(pb.classCount.size(), 0);
+    int maxOcc = 1, totalOcc = 0;
+    for (size_t i = 0; i < n; ++i) {
+        classWork[pb.cls[i]] += pb.occ[i];
+        maxOcc = std::max(maxOcc, pb.occ[i]);
+        totalOcc += pb.occ[i];
+    }
+    ms.resMII = 1;
+    for (size_t c = 0; c < classWork.size(); ++c) {
+        if (pb.classCount[c] <= 0) continue;
+        ms.resMII = std::max(ms.resMII, (int)((classWork[c] + pb.classCount[c] - 1) / pb.classCount[c]));
+    }
+    // Дерево виразу ациклічне: залежностей між ітераціями немає
+    ms.recMII = 1;
+
+    // Порядок — за спаданням висоти (він же топологічний, бо латентності додатні)
+    std::vector<int> height(n, 0);
+    for (int i = (int)n - 1; i >= 0; --i) {
+        int tail = 0;
+        for (int s : graph.succs(i)) tail = std::max(tail, height[s]);
+        height[i] = pb.lat[i] + tail;
+    }
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return height[a] > height[b]; });
+
+    int mii = std::max({ms.resMII, ms.recMII, maxOcc});
+    for (int ii = mii; ii <= totalOcc + maxOcc; ++ii) {
+        if (placeWithII(graph, pb, order, classUnits, ii, ms)) {
+            ms.ii = ii;
+            ms.ok = true;
+            break;
+        }
+    }
+    return ms;
+}
+
+} // namespace
+
+// Процесори загального призначення: кожна операція займає процесор на всю тривалість
+ModuloSchedule moduloScheduleProcessors(const TaskGraph& graph, int procCount) {
+    ModuloProblem pb;
+    pb.classCount = {procCount};
+    pb.className = {"P"};
+    for (int d : graph.duration) {
+        pb.cls.push_back(0);
+        pb.lat.push_back(d);
+        pb.occ.push_back(d);
+    }
+    return solveModulo(graph, pb);
+}
+
+// Функціональні блоки: зайнятість — інтервал запуску класу, результат — через латентність
+ModuloSchedule moduloScheduleUnits(const TaskGraph& graph, const ResourceConfig& config) {
+    ModuloProblem pb;
+    for (const auto& c : config.classes) {
+        pb.classCount.push_back(c.count);
+        pb.className.push_back(c.name);
+    }
+    for (int i = 0; i < (int)graph.size(); ++i) {
+        int c = config.classFor(graph.op(i));
+        if (c < 0 || config.classes[c].count <= 0) {
+            std::cout << "Error: no functional unit for operation '" << graph.op(i) << "'" << std::endl;
+            return {};
+        }
+        pb.cls.push_back(c);
+        pb.lat.push_back(config.classes[c].latency);
+        pb.occ.push_back(config.classes[c].issueInterval());
+    }
+    return solveModulo(graph, pb);
+}
+
+void printModuloSchedule(const TaskGraph& graph, const ModuloSchedule& schedule) {
+    if (!schedule.ok) {
+        std::cout << "Error: no modulo schedule found!" << std::endl;
+        return;
+    }
+    std::cout << "II: " << schedule.ii << " (ResMII " << schedule.resMII << ", RecMII " << schedule.recMII << ")" << std::endl;
+    std::cout << "Throughput: " << schedule.throughput() << " results/cycle" << std::endl;
+    std::cout << "Latency of one evaluation: " << schedule.latency << std::endl;
+    std::cout << "Stages: " << schedule.stages << std::endl;
+
+    auto stageOps = [&](int stage) {
+        std::string ops;
+        for (const auto& s : schedule.slots) {
+            if (s.stage != stage) continue;
+            if (!ops.empty()) ops += " ";
+            ops += graph.op(s.task) + "#" + std::to_string(s.task);
+        }
+        return ops;
+    };
+    // Пролог: ітерації по черзі заповнюють стадії конвеєра
+    std::cout << "Prologue:" << std::endl;
+    for (int b = 0; b + 1 < schedule.stages; ++b) {
+        std::cout << "  block " << b << ":";
+        for (int s = 0; s <= b; ++s) std::cout << " it" << b - s << "[" << stageOps(s) << "]";
+        std::cout << std::endl;
+    }
+    // Ядро: в кожному такті ii працюють усі стадії різних ітерацій
+    std::cout << "Kernel (iteration i):" << std::endl;
+    for (int c = 0; c < schedule.ii; ++c) {
+        std::cout << "  cycle " << c << ":";
+        for (const auto& s : schedule.slots) {
+            if (s.time % schedule.ii != c) continue;
+            std::cout << " " << schedule.unitNames[s.unit] << "[" << graph.op(s.task) << "#" << s.task;
+            if (s.stage > 0) std::cout << " it i-" << s.stage;
+            std::cout << "]";
+        }
+        std::cout << std::endl;
+    }
+    // Епілог: останні ітерації доходять до кінця конвеєра
+    std::cout << "Epilogue (last iteration N-1):" << std::endl;
+    for (int b = 0; b + 1 < schedule.stages; ++b) {
+        std::cout << "  block " << b << ":";
+        for (int s = b + 1; s < schedule.stages; ++s) {
+            std::cout << " itN-" << s - b << "[" << stageOps(s) << "]";
+        }
+        std::cout << std::endl;
+    }
+}
+
+// === Потокове обчислення: модульне планування поряд з одноразовим розкладом ===
+void prsr::modelStreaming(const std::string& expr, int procCount, const std::string& unitSpec) {
+    if (!validateExpression(expr)) {
+        std::cout << "Error: the expression is not valid!" << std::endl;
+        return;
+    }
+    prsr::Node* tree = buildOptimizedTree(expr);
+    tree = prsr::optimizeParallelTree(tree);
+    if (!tree) {
+        std::cout << "Error: failed to build the tree!" << std::endl;
+        return;
+    }
+    TaskGraph graph = flattenTaskGraph(tree);
+    const int tuples = 1000;
+
+    auto assignments = assignTasksWithDependencies(tree, procCount);
+    int singleShot = 0;
+    for (const auto& t : assignments) singleShot = std::max(singleShot, t.endTime);
+    ModuloSchedule ms = moduloScheduleProcessors(graph, procCount);
+    std::cout << "\n=== Streaming on " << procCount << " processors ===" << std::endl;
+    std::cout << "Single-shot makespan (modelSystem): " << singleShot << std::endl;
+    printModuloSchedule(graph, ms);
+    if (ms.ok) {
+        std::cout << "Time for " << tuples << " tuples: one by one " << (long long)tuples * singleShot
+                  << ", pipelined " << (long long)(tuples - 1) * ms.ii + ms.latency << std::endl;
+    }
+
+    if (!unitSpec.empty()) {
+        ResourceConfig config = parseResourceConfig(unitSpec);
+        if (!config.classes.empty()) {
+            ResourceSchedule single = scheduleOnUnits(graph, config);
+            ModuloSchedule fu = moduloScheduleUnits(graph, config);
+            std::cout << "\n=== Streaming on functional units: " << unitSpec << " ===" << std::endl;
+            if (single.ok) std::cout << "Single-shot makespan: " << single.makespan << std::endl;
+            printModuloSchedule(graph, fu);
+            if (single.ok && fu.ok) {
+                std::cout << "Time for " << tuples << " tuples: one by one " << (long long)tuples * single.makespan
+                          << ", pipelined " << (long long)(tuples - 1) * fu.ii + fu.latency << std::endl;
+            }
+        }
+    }
+    delete tree;
+}
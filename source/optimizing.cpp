@@ -1,4 +1,5 @@
 #include "parser.h"
+#include "modeling.h"
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -7,9 +8,11 @@
 #include <iostream>
 #include <sstream>
 #include <stack>
+#include <queue>
 #include <algorithm> // For std::all_of
 #include <map>
 #include <utility>
+#include <charconv>
 
 using namespace prsr;
 
@@ -27,6 +30,16 @@ std::string formatNumber(double value) {
     return str;
 }
 
+// Найкоротший десятковий запис, з якого читається те саме double (без експоненти,
+// бо tokenize її не розбирає): 0.0000001 не стає 0, як у formatNumber
+std::string formatExactNumber(double value) {
+    if (value == 0.0) return "0";
+    char buffer[512];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed);
+    if (result.ec != std::errc()) return formatNumber(value);
+    return std::string(buffer, result.ptr);
+}
+
 size_t prsr::findClosingParen(const std::vector<Token>& tokens, size_t start) {
     int count = 1;
     for (size_t i = start + 1; i < tokens.size(); i++) {
@@ -197,11 +210,185 @@ Node* createBalancedStructureForAllOps(Node* root) {
     return current[0];
 }
 
-Node* prsr::optimizeParallelTree(Node* root) {
+// Heap entry for the cost-aware rebalancer: operand subtree and the time its value is ready
+struct ReadyOperand {
+    int ready;
+    int order;  // tie-break keeps the original left-to-right order
+    Node* node;
+    bool negative;  // operand is subtracted
+
+    bool operator>(const ReadyOperand& other) const {
+        return ready != other.ready ? ready > other.ready : order > other.order;
+    }
+};
+
+// Time a leaf value is available: variables from the arrival map (a "-B" leaf waits for B),
+// numbers and unlisted variables at 0
+int prsr::leafArrival(const Node* leaf, const std::map<std::string, int>& arrival) {
+    if (!leaf || !leaf->isVariable || arrival.empty()) return 0;
+    std::string name = !leaf->value.empty() && leaf->value[0] == '-' ? leaf->value.substr(1) : leaf->value;
+    auto it = arrival.find(name);
+    return it != arrival.end() ? it->second : 0;
+}
+
+// Splits a +/- group (or a */÷ group) into the terms taken with "plus" and with "minus".
+// a-(b-c) contributes b as negative and c as positive.
+void collectSigned(Node* node, const std::string& plus, const std::string& minus, bool positive,
+                   std::vector<Node*>& pos, std::vector<Node*>& neg, std::vector<Node*>& inner, bool& hasNull) {
+    if (!node) {
+        hasNull = true;
+        return;
+    }
+    if (node->isOperator && node->value == plus) {
+        inner.push_back(node);
+        for (Node* child : node->children) collectSigned(child, plus, minus, positive, pos, neg, inner, hasNull);
+        return;
+    }
+    if (node->isOperator && node->value == minus && node->children.size() == 2) {
+        inner.push_back(node);
+        collectSigned(node->children[0], plus, minus, positive, pos, neg, inner, hasNull);
+        collectSigned(node->children[1], plus, minus, !positive, pos, neg, inner, hasNull);
+        return;
+    }
+    (positive ? pos : neg).push_back(node);
+}
+
+// Rebalances every + and * chain under node. Like Huffman coding, the two operands that are
+// ready first are combined first, a subtree being ready after its critical path measured
+// with getOpDuration, starting from the arrival times of its leaves. This minimizes the
+// completion time of the chain, not only its height, and keeps late inputs near the root.
+// +/- groups are combined with signs: two subtracted operands are added and stay subtracted,
+// a kept and a subtracted operand become a difference.
+Node* rebalanceByReadyTime(Node* node, int& ready, const std::map<std::string, int>& arrival) {
+    ready = 0;
+    if (!node) return node;
+    if (!node->isOperator) {
+        ready = leafArrival(node, arrival);
+        return node;
+    }
+    std::vector<Node*> pos, neg, chain;
+    bool hasNull = false;
+    if (node->value == "+" || node->value == "-") {
+        collectSigned(node, "+", "-", true, pos, neg, chain, hasNull);
+    } else if (node->value == "*") {
+        collectSigned(node, "*", "", true, pos, neg, chain, hasNull);
+    }
+    if (pos.size() + neg.size() <= 2 || pos.empty() || hasNull) {
+        int start = 0;
+        for (auto& child : node->children) {
+            int childReady = 0;
+            child = rebalanceByReadyTime(child, childReady, arrival);
+            start = std::max(start, childReady);
+        }
+        ready = start + getOpDuration(node->value);
+        return node;
+    }
+
+    std::string op = node->value == "*" ? "*" : "+";
+    // The old chain nodes are replaced; detach the operands so they survive the delete
+    for (Node* n : chain) {
+        n->children.clear();
+        delete n;
+    }
+    std::priority_queue<ReadyOperand, std::vector<ReadyOperand>, std::greater<>> heap;
+    int order = 0;
+    auto pushOperand = [&](Node* operand, bool negative) {
+        int operandReady = 0;
+        Node* rebuilt = rebalanceByReadyTime(operand, operandReady, arrival);
+        heap.push({operandReady, order++, rebuilt, negative});
+    };
+    for (Node* operand : pos) pushOperand(operand, false);
+    for (Node* operand : neg) pushOperand(operand, true);
+    while (heap.size() > 1) {
+        ReadyOperand a = heap.top();
+        heap.pop();
+        ReadyOperand b = heap.top();
+        heap.pop();
+        bool difference = a.negative != b.negative;
+        Node* combined = new Node(difference ? "-" : op, true, false, false);
+        // In a difference the kept operand goes first
+        if (difference && a.negative) std::swap(a, b);
+        combined->children.push_back(a.node);
+        combined->children.push_back(b.node);
+        heap.push({std::max(a.ready, b.ready) + getOpDuration(combined->value), order++, combined,
+                   !difference && a.negative});
+    }
+    ready = heap.top().ready;
+    return heap.top().node;
+}
+
+Node* prsr::rebalanceChains(Node* root, const std::map<std::string, int>& arrival) {
+    if (!root) return nullptr;
+    int ready = 0;
+    return rebalanceByReadyTime(root, ready, arrival);
+}
+
+Node* prsr::optimizeParallelTree(Node* root, const std::map<std::string, int>& arrival) {
+    // Sign propagation turns - and / chains into + and * chains the rebalancer can parallelize
+    Node* result = rebalanceChains(propagateSigns(root), arrival);
+    hashTree(result);
+    return result;
+}
+
+Node* chainOf(const std::vector<Node*>& terms, const std::string& op) {
+    Node* acc = terms[0];
+    for (size_t i = 1; i < terms.size(); ++i) {
+        Node* next = new Node(op, true, false, false);
+        next->children.push_back(acc);
+        next->children.push_back(terms[i]);
+        acc = next;
+    }
+    return acc;
+}
+
+// a-b-c-d -> a-(b+c+d), a/b/c/d -> a/(b*c*d), mixed chains a+b-c+d-e -> (a+b+d)-(c+e)
+Node* prsr::propagateSigns(Node* node) {
+    if (!node || !node->isOperator) return node;
+    std::string plus, minus;
+    if (node->value == "+" || node->value == "-") {
+        plus = "+";
+        minus = "-";
+    } else if (node->value == "*" || node->value == "/") {
+        plus = "*";
+        minus = "/";
+    } else {
+        for (auto& child : node->children) child = propagateSigns(child);
+        return node;
+    }
+    std::vector<Node*> pos, neg, inner;
+    bool hasNull = false;
+    collectSigned(node, plus, minus, true, pos, neg, inner, hasNull);
+    // The leftmost term of a group is always positive
+    if (hasNull || pos.empty() || neg.empty()) {
+        // Nothing to move: keep the group and continue below its terms
+        std::function<void(Node*)> visitTerms = [&](Node* n) {
+            for (auto& child : n->children) {
+                if (child && child->isOperator && child->value == plus) visitTerms(child);
+                else child = propagateSigns(child);
+            }
+        };
+        visitTerms(node);
+        return node;
+    }
+    for (Node* n : inner) {
+        n->children.clear();
+        delete n;
+    }
+    for (auto& term : pos) term = propagateSigns(term);
+    for (auto& term : neg) term = propagateSigns(term);
+    Node* result = new Node(minus, true, false, false);
+    result->children.push_back(chainOf(pos, plus));
+    result->children.push_back(chainOf(neg, plus));
+    return result;
+}
+
+// Former optimizeParallelTree: operands of each chain paired left to right, level by level.
+// Kept as the baseline for the rebalancing benchmark.
+Node* prsr::balanceTreeByLevels(Node* root) {
     if (!root) return nullptr;
     // First, recursively optimize children
     for (size_t i = 0; i < root->children.size(); i++) {
-        root->children[i] = prsr::optimizeParallelTree(root->children[i]);
+        root->children[i] = prsr::balanceTreeByLevels(root->children[i]);
     }
     // If this is an operator node, try to create parallel structure for any operator
     if (root->isOperator && (root->value == "+" || root->value == "*")) {
@@ -553,46 +740,13 @@ std::string prsr::flattenExpandMinus(Node* root) {
 Node* prsr::cloneSubtree(Node* node) {
     if (!node) return nullptr;
     Node* copy = new Node(node->value, node->isOperator, node->isNumber, node->isVariable);
+    copy->hash = node->hash;
     for (auto* child : node->children) {
         copy->children.push_back(cloneSubtree(child));
     }
     return copy;
 }
 
-Node* prsr::applyDistributive(Node* node) {
-    if (!node) return nullptr;
-    // Рекурсивно обробити дітей
-    for (size_t i = 0; i < node->children.size(); ++i) {
-        node->children[i] = applyDistributive(node->children[i]);
-    }
-    // Якщо це множення і один з дітей — додавання
-    if (node->isOperator && node->value == "*") {
-        Node* left = node->children[0];
-        Node* right = node->children[1];
-        if (left && left->isOperator && left->value == "+") {
-            Node* newPlus = new Node("+", true, false, false);
-            for (auto* lchild : left->children) {
-                Node* mul = new Node("*", true, false, false);
-                mul->children.push_back(cloneSubtree(lchild));
-                mul->children.push_back(cloneSubtree(right));
-                newPlus->children.push_back(applyDistributive(mul));
-            }
-            return newPlus;
-        }
-        if (right && right->isOperator && right->value == "+") {
-            Node* newPlus = new Node("+", true, false, false);
-            for (auto* rchild : right->children) {
-                Node* mul = new Node("*", true, false, false);
-                mul->children.push_back(cloneSubtree(left));
-                mul->children.push_back(cloneSubtree(rchild));
-                newPlus->children.push_back(applyDistributive(mul));
-            }
-            return newPlus;
-        }
-    }
-    return node;
-}
-
 Node* prsr::applyAssociative(Node* node) {
     if (!node) return nullptr;
     // Рекурсивно обробити дітей
@@ -625,89 +779,6 @@ Node* prsr::applyAssociative(Node* node) {
     return node;
 }
 
-// Факторизація: a*b + a*c → a*(b+c)
-Node* prsr::factorize(Node* node) {
-    if (!node) return nullptr;
-    // Рекурсивно обробити дітей
-    for (size_t i = 0; i < node->children.size(); ++i) {
-        node->children[i] = factorize(node->children[i]);
-    }
-    // Працюємо лише для додавання
-    if (node->isOperator && node->value == "+") {
-        // Зберемо множники для кожного доданка
-        std::vector<std::vector<Node*>> factors;
-        for (auto* child : node->children) {
-            if (child->isOperator && child->value == "*") {
-                factors.push_back(child->children);
-            } else {
-                factors.push_back({child});
-            }
-        }
-        // Пошук множників, які зустрічаються у >=2 доданках
-        std::map<std::string, int> freq;
-        for (const auto& fs : factors) {
-            for (auto* f : fs) freq[f->value]++;
-        }
-        // Знайти найчастіший множник, який зустрічається у >=2 доданках
-        std::string best;
-        int bestCount = 1;
-        for (const auto& p : freq) {
-            if (p.second > bestCount) {
-                best = p.first;
-                bestCount = p.second;
-            }
-        }
-        if (bestCount > 1) {
-            // Винести best за дужки
-            Node* newMul = new Node("*", true, false, false);
-            newMul->children.push_back(new Node(best, false, false, true));
-            Node* newPlus = new Node("+", true, false, false);
-            std::vector<Node*> restTerms;
-            for (auto& fs : factors) {
-                bool found = false;
-                std::vector<Node*> rest;
-                for (auto* f : fs) {
-                    if (f->value == best && !found) found = true;
-                    else rest.push_back(prsr::cloneSubtree(f));
-                }
-                if (found) {
-                    if (rest.empty()) {
-                        rest.push_back(new Node("1", false, true, false));
-                    }
-                    if (rest.size() == 1) {
-                        newPlus->children.push_back(rest[0]);
-                    } else {
-                        Node* mul = new Node("*", true, false, false);
-                        for (auto* r : rest) mul->children.push_back(r);
-                        newPlus->children.push_back(mul);
-                    }
-                } else {
-                    // Доданки без best залишаємо для подальшої факторизації
-                    if (fs.size() == 1) restTerms.push_back(prsr::cloneSubtree(fs[0]));
-                    else {
-                        Node* mul = new Node("*", true, false, false);
-                        for (auto* r : fs) mul->children.push_back(prsr::cloneSubtree(r));
-                        restTerms.push_back(mul);
-                    }
-                }
-            }
-            newMul->children.push_back(factorize(newPlus));
-            if (!restTerms.empty()) {
-                Node* restPlus = new Node("+", true, false, false);
-                for (auto* t : restTerms) restPlus->children.push_back(t);
-                // Рекурсивно факторизуємо залишок
-                Node* result = new Node("+", true, false, false);
-                result->children.push_back(newMul);
-                result->children.push_back(factorize(restPlus));
-                return result;
-            } else {
-                return newMul;
-            }
-        }
-    }
-    return node;
-}
-
 } // namespace prsr
 
 
@@ -2,15 +2,34 @@
 
 #include <string>
 #include <vector>
+#include <map>
 #include <climits>
+#include <cstdint>
+#include <cstddef>
 
 namespace prsr {
+    // 128-бітний канонічний структурний хеш виразу (нуль — ще не обчислено)
+    struct Hash128 {
+        uint64_t hi = 0;
+        uint64_t lo = 0;
+
+        bool empty() const { return hi == 0 && lo == 0; }
+        bool operator==(const Hash128& other) const { return hi == other.hi && lo == other.lo; }
+        bool operator!=(const Hash128& other) const { return !(*this == other); }
+        bool operator<(const Hash128& other) const { return hi != other.hi ? hi < other.hi : lo < other.lo; }
+    };
+
+    struct Hash128Hasher {
+        size_t operator()(const Hash128& h) const { return (size_t)(h.lo ^ (h.hi * 0x9e3779b97f4a7c15ull)); }
+    };
+
     struct Node {
         std::string value;
         bool isOperator;
         bool isNumber;
         bool isVariable;
         std::vector<Node*> children;
+        Hash128 hash;  // заповнює hashTree; актуальний після buildOptimizedTree і optimizeParallelTree
 
         Node(const std::string& val, bool op, bool num = false, bool var = false)
             : value(val), isOperator(op), isNumber(num), isVariable(var), children() {}
@@ -50,6 +69,8 @@ namespace prsr {
     bool isOperator(char c);
     Token createToken(const std::string& val);
     int getPrecedence(const std::string& op);
+    std::string formatNumber(double value);
+    std::string formatExactNumber(double value);
 
     // Main parser functions
     std::vector<std::string> checkExpression(const char* expr);
@@ -58,7 +79,33 @@ namespace prsr {
     std::string optimizeExpression(std::string& expression);
     std::string simplifyExpression(const std::string& expr);
     Node* buildParseTree(const std::string& expr);
-    Node* optimizeParallelTree(Node* root);
+    // arrival: момент надходження змінних; ланцюжки + і * перебудовуються так, щоб пізні входи були ближче до кореня
+    Node* optimizeParallelTree(Node* root, const std::map<std::string, int>& arrival = {});
+    int leafArrival(const Node* leaf, const std::map<std::string, int>& arrival);
+    Node* rebalanceChains(Node* root, const std::map<std::string, int>& arrival = {});
+    Node* propagateSigns(Node* root);
+    Node* balanceTreeByLevels(Node* root);
+    // Зведення подібних доданків у сумах добутків: A+B+A+A-B -> 3*A
+    Node* collectLikeTerms(Node* root);
+    // Сталі ланцюжків + і * згортаються в одне число, операнди — у канонічному порядку
+    Node* canonicalizeChains(Node* node);
+    // Розбиває групу +/- (або */÷) на доданки зі знаком plus і зі знаком minus
+    void collectSigned(Node* node, const std::string& plus, const std::string& minus, bool positive,
+                       std::vector<Node*>& pos, std::vector<Node*>& neg, std::vector<Node*>& inner, bool& hasNull);
+
+    struct StrengthReport {
+        int reciprocals = 0;      // X/4 -> X*0.25
+        int doublings = 0;        // X*2 -> X+X
+        int sharedDivisions = 0;  // ділення, зекономлені спільним знаменником
+    };
+    Node* reduceStrength(Node* root, StrengthReport* report = nullptr);
+
+    // Структурний хеш з точністю до комутативності, асоціативності і зайвих дужок:
+    // A+(B+C) і C+B+A, A-(B-C) і A+C-B дають один хеш
+    Hash128 hashTree(Node* root);
+    Hash128 expressionHash(const std::string& expr);
+    Hash128 textHash(const std::string& text);    // хеш самого тексту, без розбору
+    bool sameExpression(Node* a, Node* b);
 
     // Additional helper functions for tree building
     Node* buildTreeFromTokens(const std::vector<Token>& tokens, size_t start, size_t end);
@@ -122,8 +169,43 @@ namespace prsr {
 
     std::string flattenExpandMinus(Node* root);
     Node* cloneSubtree(Node* node);
+    struct DistributiveLimits {
+        int maxNodes = 4096;      // найбільший приріст дерева і нових вузлів DAG
+        bool requireGain = true;  // розкривати лише там, де модель вартості обіцяє виграш
+    };
+    struct DistributiveReport {
+        int expanded = 0;
+        int skippedBudget = 0;
+        int skippedNoGain = 0;
+        int dagNodes = 0;
+    };
     Node* applyDistributive(Node* node);
+    Node* applyDistributive(Node* node, const DistributiveLimits& limits, DistributiveReport* report = nullptr);
     Node* applyAssociative(Node* node);
+    // Багатовимірна схема Горнера: жадібно виносить найвигідніший спільний множник
     Node* factorize(Node* node);
     void modelSystem(const std::string& expr, int procCount);
+    void simulateSystem(const std::string& expr, int procCount);
+    void benchmarkSimulator();
+    void modelHeterogeneousSystem(const std::string& expr, const std::string& machineSpec);
+    void modelFunctionalUnits(const std::string& expr, const std::string& unitSpec);
+    void modelStreaming(const std::string& expr, int procCount, const std::string& unitSpec);
+    void executeSystem(const std::string& expr, const std::string& bindings);
+    void executeStaticSystem(const std::string& expr, const std::string& bindings, int procCount);
+    void runExpressionPipeline(const std::string& exprList, int procCount, int repeat);
+    void benchmarkRebalancing(int procCount);
+    void benchmarkSignPropagation(int procCount);
+    void modelArrivals(const std::string& expr, const std::string& arrivalSpec, int procCount);
+    void optimizeForProcessors(const std::string& expr);
+    void benchmarkLikeTerms();
+    void modelFactoring(const std::string& expr, int procCount);
+    void modelStrengthReduction(const std::string& expr, int procCount);
+    void benchmarkDistributive();
+    void benchmarkResultCache();
+    void benchmarkWarmStart(const std::string& cachePath);
+    void benchmarkSerialization();
+    void modelExpressionSystem(const std::string& systemText, int procCount);
+    void benchmarkExpressionSystem();
+    void sweepProcessorCounts(const std::string& expr, const std::string& rangeText);
+    void benchmarkProcessorSweep();
 }
\ No newline at end of file
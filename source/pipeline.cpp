@@ -0,0 +1,436 @@
+#include "parser.h"
+#include "modeling.h"
+#include "pipeline.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <functional>
+#include <coroutine>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const char* kStageNames[StageCount] = {"read", "correct", "simplify", "tree", "schedule", "emit"};
+
+// Фіксований пул потоків, який відновлює готові до продовження корутини
+class Scheduler {
+public:
+    explicit Scheduler(int threadCount) {
+        for (int i = 0; i < std::max(1, threadCount); ++i) threads.emplace_back([this] { loop(); });
+    }
+
+    ~Scheduler() {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            stop = true;
+        }
+        cv.notify_all();
+        for (auto& t : threads) t.join();
+    }
+
+    void schedule(std::coroutine_handle<> handle) {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            ready.push_back(handle);
+        }
+        cv.notify_one();
+    }
+
+private:
+    void loop() {
+        while (true) {
+            std::coroutine_handle<> handle;
+            {
+                std::unique_lock<std::mutex> lock(m);
+                cv.wait(lock, [&] { return stop || !ready.empty(); });
+                if (ready.empty()) return;
+                handle = ready.front();
+                ready.pop_front();
+            }
+            handle.resume();
+        }
+    }
+
+    std::vector<std::thread> threads;
+    std::mutex m;
+    std::condition_variable cv;
+    std::deque<std::coroutine_handle<>> ready;
+    bool stop = false;
+};
+
+// Корутина робітника: стартує лише після передачі в планувальник, по завершенні знищується сама
+struct StageTask {
+    struct promise_type {
+        StageTask get_return_object() { return {std::coroutine_handle<promise_type>::from_promise(*this)}; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Обмежений канал: push призупиняє виробника, коли канал повний (зворотний тиск),
+// pop призупиняє споживача, коли канал порожній. Після close pop повертає nullopt.
+template <class T>
+class Channel {
+public:
+    struct PopAwaiter;
+
+    struct PushAwaiter {
+        Channel& ch;
+        T value;
+        std::coroutine_handle<> handle;
+
+        bool await_ready() { return false; }
+        bool await_suspend(std::coroutine_handle<> h) {
+            std::lock_guard<std::mutex> lock(ch.m);
+            if (!ch.poppers.empty()) {
+                PopAwaiter* waiter = ch.poppers.front();
+                ch.poppers.pop_front();
+                waiter->result = std::move(value);
+                ch.sched.schedule(waiter->handle);
+                return false;
+            }
+            if (ch.items.size() < ch.capacity) {
+                ch.items.push_back(std::move(value));
+                ch.sample();
+                return false;
+            }
+            handle = h;
+            ch.pushers.push_back(this);
+            ch.blockedPushes++;
+            return true;
+        }
+        void await_resume() {}
+    };
+
+    struct PopAwaiter {
+        Channel& ch;
+        std::optional<T> result;
+        std::coroutine_handle<> handle;
+
+        bool await_ready() { return false; }
+        bool await_suspend(std::coroutine_handle<> h) {
+            std::lock_guard<std::mutex> lock(ch.m);
+            if (!ch.items.empty()) {
+                result = std::move(ch.items.front());
+                ch.items.pop_front();
+                // Звільнене місце одразу займає перший виробник, що чекає
+                if (!ch.pushers.empty()) {
+                    PushAwaiter* waiter = ch.pushers.front();
+                    ch.pushers.pop_front();
+                    ch.items.push_back(std::move(waiter->value));
+                    ch.sched.schedule(waiter->handle);
+                }
+                ch.sample();
+                return false;
+            }
+            if (ch.closed) return false;
+            handle = h;
+            ch.poppers.push_back(this);
+            return true;
+        }
+        std::optional<T> await_resume() { return std::move(result); }
+    };
+
+    Channel(Scheduler& sched, size_t capacity) : sched(sched), capacity(std::max<size_t>(1, capacity)) {}
+
+    PushAwaiter push(T value) { return {*this, std::move(value), {}}; }
+    PopAwaiter pop() { return {*this, std::nullopt, {}}; }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(m);
+        closed = true;
+        for (PopAwaiter* waiter : poppers) sched.schedule(waiter->handle);
+        poppers.clear();
+    }
+
+    ChannelMetrics metrics() {
+        std::lock_guard<std::mutex> lock(m);
+        ChannelMetrics r;
+        r.capacity = (int)capacity;
+        r.avgDepth = samples > 0 ? (double)depthSum / samples : 0.0;
+        r.maxDepth = (int)maxDepth;
+        r.blockedPushes = blockedPushes;
+        return r;
+    }
+
+private:
+    void sample() {
+        depthSum += items.size();
+        maxDepth = std::max(maxDepth, items.size());
+        ++samples;
+    }
+
+    Scheduler& sched;
+    size_t capacity;
+    std::mutex m;
+    std::deque<T> items;
+    std::deque<PushAwaiter*> pushers;
+    std::deque<PopAwaiter*> poppers;
+    bool closed = false;
+    unsigned long long depthSum = 0;
+    unsigned long long samples = 0;
+    size_t maxDepth = 0;
+    long long blockedPushes = 0;
+};
+
+// Стан виразу, що проходить конвеєр
+struct PipelineItem {
+    size_t id;
+    std::string expr;
+    bool valid = false;
+    prsr::Node* tree = nullptr;
+    PipelineResult result;
+};
+
+using ItemChannel = Channel<PipelineItem*>;
+
+struct StageState {
+    std::function<void(PipelineItem&)> fn;
+    std::atomic<int> liveWorkers{0};
+    std::atomic<long long> processed{0};
+    std::atomic<long long> busyNs{0};
+};
+
+// Спільний лічильник живих корутин: run чекає, поки він не впаде до нуля
+void finishCoroutine(std::atomic<int>& live) {
+    if (live.fetch_sub(1, std::memory_order_acq_rel) == 1) live.notify_all();
+}
+
+StageTask readWorker(std::vector<PipelineItem>& items, ItemChannel& out, StageState& state, std::atomic<int>& live) {
+    for (auto& item : items) {
+        auto t0 = Clock::now();
+        state.fn(item);
+        state.busyNs += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count();
+        state.processed++;
+        co_await out.push(&item);
+    }
+    out.close();
+    finishCoroutine(live);
+}
+
+StageTask stageWorker(ItemChannel& in, ItemChannel* out, StageState& state, std::atomic<int>& live) {
+    while (true) {
+        std::optional<PipelineItem*> item = co_await in.pop();
+        if (!item) break;
+        auto t0 = Clock::now();
+        state.fn(**item);
+        state.busyNs += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count();
+        state.processed++;
+        if (out) co_await out->push(*item);
+    }
+    // Останній робітник стадії закриває вихідний канал
+    if (state.liveWorkers.fetch_sub(1, std::memory_order_acq_rel) == 1 && out) out->close();
+    finishCoroutine(live);
+}
+
+void correctStage(PipelineItem& item) {
+    // checkExpression і correctExpression пишуть у глобальний prsr::errors,
+    // тому стадія виправлення серіалізована незалежно від кількості робітників
+    std::lock_guard<std::mutex> lock(parserErrorsMutex);
+    const int maxIterations = 40;
+    for (int iter = 0; iter < maxIterations; ++iter) {
+        prsr::errors.clear();
+        prsr::checkExpression(item.expr.c_str());
+        if (prsr::errors.empty()) break;
+        item.expr = prsr::correctExpression(&item.expr[0], prsr::errors);
+    }
+    item.valid = prsr::errors.empty() && !item.expr.empty();
+    prsr::errors.clear();
+}
+
+void simplifyStage(PipelineItem& item) {
+    if (!item.valid) return;
+    const int maxIterations = 40;
+    std::string prev;
+    for (int iter = 0; iter < maxIterations && item.expr != prev; ++iter) {
+        prev = item.expr;
+        item.expr = prsr::simplifyExpression(item.expr);
+    }
+}
+
+void treeStage(PipelineItem& item) {
+    if (!item.valid) return;
+    item.tree = prsr::optimizeParallelTree(buildOptimizedTree(item.expr));
+    item.valid = item.tree != nullptr;
+}
+
+// Результати планування за структурним хешем дерева: однакові вирази пакета плануються один раз
+struct ScheduleMemo {
+    std::mutex mutex;
+    std::unordered_map<prsr::Hash128, PipelineResult, prsr::Hash128Hasher> results;
+    std::atomic<long long> hits{0};
+};
+
+void scheduleStage(PipelineItem& item, int procCount, ScheduleMemo& memo) {
+    if (!item.valid) return;
+    prsr::Hash128 key = item.tree->hash;
+    {
+        std::lock_guard<std::mutex> lock(memo.mutex);
+        auto it = memo.results.find(key);
+        if (it != memo.results.end()) {
+            item.result.operations = it->second.operations;
+            item.result.makespan = it->second.makespan;
+            item.result.usedProcs = it->second.usedProcs;
+            memo.hits++;
+            delete item.tree;
+            item.tree = nullptr;
+            return;
+        }
+    }
+    auto assignments = assignTasksWithDependencies(item.tree, procCount);
+    std::vector<char> used(procCount, 0);
+    for (const auto& t : assignments) {
+        item.result.makespan = std::max(item.result.makespan, t.endTime);
+        if (t.proc >= 0 && t.proc < procCount) used[t.proc] = 1;
+    }
+    item.result.operations = (int)assignments.size();
+    item.result.usedProcs = (int)std::count(used.begin(), used.end(), 1);
+    {
+        std::lock_guard<std::mutex> lock(memo.mutex);
+        memo.results.emplace(key, item.result);
+    }
+    delete item.tree;
+    item.tree = nullptr;
+}
+
+void emitStage(PipelineItem& item) {
+    item.result.expression = item.expr;
+    item.result.valid = item.valid;
+}
+
+} // namespace
+
+// Конвеєр на корутинах C++20: кожна стадія — набір корутин-робітників між обмеженими каналами,
+// тож багато виразів обробляються одночасно, а повільна стадія гальмує лише своїх виробників
+PipelineReport runPipeline(const std::vector<std::string>& inputs, const PipelineConfig& config) {
+    PipelineReport report;
+    std::vector<PipelineItem> items(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        items[i].id = i;
+        items[i].result.input = inputs[i];
+    }
+
+    StageState states[StageCount];
+    states[StageRead].fn = [](PipelineItem& item) {
+        item.expr = item.result.input;
+        item.expr.erase(std::remove_if(item.expr.begin(), item.expr.end(), ::isspace), item.expr.end());
+    };
+    states[StageCorrect].fn = correctStage;
+    states[StageSimplify].fn = simplifyStage;
+    states[StageTree].fn = treeStage;
+    ScheduleMemo memo;
+    states[StageSchedule].fn = [&](PipelineItem& item) { scheduleStage(item, config.procCount, memo); };
+    states[StageEmit].fn = emitStage;
+
+    auto t0 = Clock::now();
+    {
+        // live переживає планувальник: остання корутина ще може сповіщати про завершення
+        std::atomic<int> live{0};
+        Scheduler sched(config.threads);
+        std::vector<std::unique_ptr<ItemChannel>> channels;
+        for (int s = 0; s < StageCount; ++s) channels.push_back(std::make_unique<ItemChannel>(sched, config.channelCapacity));
+
+        std::vector<StageTask> tasks;
+        for (int s = StageCorrect; s < StageCount; ++s) {
+            int workers = std::max(1, config.workers[s]);
+            states[s].liveWorkers = workers;
+            ItemChannel* out = s + 1 < StageCount ? channels[s + 1].get() : nullptr;
+            for (int w = 0; w < workers; ++w) tasks.push_back(stageWorker(*channels[s], out, states[s], live));
+        }
+        states[StageRead].liveWorkers = 1;
+        tasks.push_back(readWorker(items, *channels[StageCorrect], states[StageRead], live));
+        live = (int)tasks.size();
+        for (auto& t : tasks) sched.schedule(t.handle);
+
+        for (int n = live.load(); n != 0; n = live.load()) live.wait(n);
+        for (int s = StageCorrect; s < StageCount; ++s) report.channels[s] = channels[s]->metrics();
+    }
+    report.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    for (int s = 0; s < StageCount; ++s) {
+        auto& m = report.stages[s];
+        m.workers = s == StageRead ? 1 : std::max(1, config.workers[s]);
+        m.processed = states[s].processed;
+        m.busySeconds = states[s].busyNs * 1e-9;
+        m.occupancy = report.seconds > 0 ? m.busySeconds / (report.seconds * m.workers) : 0.0;
+    }
+    for (auto& item : items) report.results.push_back(item.result);
+    report.deduplicated = memo.hits;
+    return report;
+}
+
+void printPipelineReport(const PipelineReport& report) {
+    std::cout << "Expressions: " << report.results.size() << ", time: " << report.seconds << " s, rate: "
+              << (report.seconds > 0 ? report.results.size() / report.seconds : 0.0) << " expr/s" << std::endl;
+    std::cout << "Scheduled once per structural hash, duplicates skipped: " << report.deduplicated << std::endl;
+    std::cout << "Stage    | workers | processed | busy, ms | occupancy | queue avg | queue max | blocked" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (int s = 0; s < StageCount; ++s) {
+        const auto& m = report.stages[s];
+        const auto& c = report.channels[s];
+        std::cout << std::left << std::setw(8) << kStageNames[s] << std::right
+                  << " | " << std::setw(7) << m.workers
+                  << " | " << std::setw(9) << m.processed
+                  << " | " << std::setw(8) << m.busySeconds * 1e3
+                  << " | " << std::setw(8) << m.occupancy * 100.0 << "%";
+        if (s == StageRead) {
+            std::cout << " |         - |         - |       -" << std::endl;
+        } else {
+            std::cout << " | " << std::setw(9) << c.avgDepth << " | " << std::setw(5) << c.maxDepth << "/" << std::setw(3) << c.capacity
+                      << " | " << std::setw(7) << c.blockedPushes << std::endl;
+        }
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+}
+
+// === Пакетна обробка виразів (через ';') конвеєром ===
+void prsr::runExpressionPipeline(const std::string& exprList, int procCount, int repeat) {
+    std::vector<std::string> inputs;
+    std::stringstream items(exprList);
+    std::string item;
+    while (std::getline(items, item, ';')) {
+        if (!item.empty()) inputs.push_back(item);
+    }
+    if (inputs.empty()) {
+        std::cout << "Error: no expressions to process!" << std::endl;
+        return;
+    }
+    size_t distinct = inputs.size();
+    for (int r = 1; r < repeat; ++r) {
+        for (size_t i = 0; i < distinct; ++i) inputs.push_back(inputs[i]);
+    }
+
+    PipelineConfig config;
+    config.procCount = procCount;
+    config.threads = (int)std::max(2u, std::thread::hardware_concurrency());
+    PipelineReport report = runPipeline(inputs, config);
+
+    std::cout << "\n=== Expression pipeline on " << config.threads << " threads ===" << std::endl;
+    for (size_t i = 0; i < distinct; ++i) {
+        const auto& r = report.results[i];
+        if (!r.valid) {
+            std::cout << r.input << " -> invalid" << std::endl;
+            continue;
+        }
+        std::cout << r.input << " -> " << r.expression << ": " << r.operations << " ops, makespan "
+                  << r.makespan << " on " << r.usedProcs << " processors" << std::endl;
+    }
+    printPipelineReport(report);
+}
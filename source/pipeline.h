@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Стадії конвеєра обробки виразів
+enum PipelineStage {
+    StageRead,
+    StageCorrect,    // перевірка і виправлення помилок
+    StageSimplify,
+    StageTree,       // побудова та балансування дерева
+    StageSchedule,
+    StageEmit,
+    StageCount
+};
+
+struct PipelineConfig {
+    int threads = 4;                    // потоки, що відновлюють корутини
+    int channelCapacity = 8;            // місткість каналу між стадіями
+    int workers[StageCount] = {1, 1, 2, 2, 2, 1};
+    int procCount = 6;                  // процесори моделі на стадії планування
+};
+
+struct StageMetrics {
+    int workers = 0;
+    long long processed = 0;
+    double busySeconds = 0.0;
+    double occupancy = 0.0;             // busy / (час роботи * кількість робітників)
+};
+
+// Метрики каналу на вході стадії
+struct ChannelMetrics {
+    int capacity = 0;
+    double avgDepth = 0.0;
+    int maxDepth = 0;
+    long long blockedPushes = 0;        // скільки разів спрацював зворотний тиск
+};
+
+struct PipelineResult {
+    std::string input;
+    std::string expression;             // після виправлення і спрощення
+    bool valid = false;
+    int operations = 0;
+    int makespan = 0;
+    int usedProcs = 0;
+};
+
+struct PipelineReport {
+    std::vector<PipelineResult> results;     // у порядку вхідних виразів
+    StageMetrics stages[StageCount];
+    ChannelMetrics channels[StageCount];     // channels[s] — вхід стадії s (для StageRead порожній)
+    double seconds = 0.0;
+    long long deduplicated = 0;              // вирази, чий план узято за структурним хешем
+};
+
+PipelineReport runPipeline(const std::vector<std::string>& inputs, const PipelineConfig& config);
+void printPipelineReport(const PipelineReport& report);
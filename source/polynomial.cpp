@@ -0,0 +1,492 @@
+#include "parser.h"
+#include "modeling.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <cmath>
+
+using namespace prsr;
+
+namespace {
+
+// Одночлен — відсортований список номерів множників (A*A*B -> [a, a, b])
+using Monomial = std::vector<int>;
+
+struct MonomialHash {
+    size_t operator()(const Monomial& m) const {
+        size_t h = 1469598103934665603ull;
+        for (int id : m) {
+            h ^= (size_t)id + 0x9e3779b97f4a7c15ull;
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+};
+
+struct Term {
+    double coef = 0.0;
+    size_t order = 0;   // перша поява — порядок доданків після перебудови
+};
+
+struct PolyTerm {
+    Monomial monomial;
+    double coef = 0.0;
+};
+
+// Розріджений многочлен: одночлен -> коефіцієнт. Множники — змінні або непрозорі
+// піддерева (ділення, сума всередині добутку), зведені до рядка-ключа.
+class SparsePolynomial {
+public:
+    // normalize застосовується до кожного непрозорого множника перед порівнянням
+    explicit SparsePolynomial(Node* (*normalize)(Node*)) : normalize(normalize) {}
+    ~SparsePolynomial() {
+        for (Node* atom : atoms) delete atom;
+    }
+
+    // Додає добуток (або одиночний множник) зі знаком sign; вузол node переходить у власність
+    void addProduct(Node* node, double sign) {
+        Monomial m;
+        double coef = sign;
+        // second: множник уже нормалізовано (повторно normalize не викликаємо)
+        std::vector<std::pair<Node*, bool>> stack = {{node, false}};
+        while (!stack.empty()) {
+            auto [n, normalized] = stack.back();
+            stack.pop_back();
+            if (n && n->isOperator && n->value == "*" && n->children.size() == 2) {
+                stack.push_back({n->children[1], normalized});
+                stack.push_back({n->children[0], normalized});
+                n->children.clear();
+                delete n;
+            } else if (n && n->isNumber) {
+                coef *= std::stod(n->value);
+                delete n;
+            } else if (n && n->isOperator && !normalized) {
+                // Нормалізований множник може стати добутком (A+A -> 2*A): його коефіцієнт
+                // і множники входять в одночлен, а не в непрозорий атом
+                stack.push_back({normalize(n), true});
+            } else {
+                m.push_back(intern(n, coef));
+            }
+        }
+        std::sort(m.begin(), m.end());
+        auto it = terms.find(m);
+        if (it == terms.end()) {
+            terms.emplace(std::move(m), Term{coef, terms.size()});
+        } else {
+            it->second.coef += coef;
+        }
+    }
+
+    // Ненульові доданки в порядку першої появи, стала — останньою
+    std::vector<PolyTerm> liveTerms() const {
+        std::vector<const std::pair<const Monomial, Term>*> ordered(terms.size());
+        for (const auto& entry : terms) ordered[entry.second.order] = &entry;
+        std::vector<PolyTerm> live;
+        double constant = 0.0;
+        for (const auto* entry : ordered) {
+            if (entry->second.coef == 0.0) continue;  // лише точне скорочення: малі коефіцієнти — справжні доданки
+            if (entry->first.empty()) constant += entry->second.coef;
+            else live.push_back({entry->first, entry->second.coef});
+        }
+        if (constant != 0.0) live.push_back({Monomial(), constant});
+        return live;
+    }
+
+    // Мінімальне за кількістю операцій дерево: кожен одночлен один раз, коефіцієнт ±1 без множення
+    Node* build() { return buildSum(liveTerms()); }
+
+    // Жадібна багатовимірна схема Горнера: поки є множник, винесення якого за дужки
+    // економить множення (з вагою getOpDuration), виносимо найвигідніший
+    Node* buildHorner(const std::vector<PolyTerm>& live) {
+        if (live.size() <= 1) return buildSum(live);
+        // Скільки множень зникає, якщо винести id: доданок, що стає 1, множення не мав
+        std::unordered_map<int, int> saved;
+        for (const auto& t : live) {
+            bool keepsMul = t.monomial.size() > 1 || std::fabs(t.coef) != 1.0;
+            for (size_t i = 0; i < t.monomial.size(); ++i) {
+                if (i > 0 && t.monomial[i] == t.monomial[i - 1]) continue;
+                saved[t.monomial[i]] += keepsMul ? 1 : 0;
+            }
+        }
+        int best = -1, bestGain = 0;
+        for (const auto& [id, count] : saved) {
+            // Винесений множник сам коштує одне множення
+            int gain = (count - 1) * getOpDuration("*");
+            if (gain > bestGain || (gain == bestGain && gain > 0 && id < best)) {
+                best = id;
+                bestGain = gain;
+            }
+        }
+        if (best < 0) return buildSum(live);
+        std::vector<PolyTerm> quotient, rest;
+        for (const auto& t : live) {
+            auto it = std::find(t.monomial.begin(), t.monomial.end(), best);
+            if (it == t.monomial.end()) {
+                rest.push_back(t);
+                continue;
+            }
+            PolyTerm q = t;
+            q.monomial.erase(q.monomial.begin() + (it - t.monomial.begin()));
+            quotient.push_back(std::move(q));
+        }
+        Node* factored = new Node("*", true, false, false);
+        factored->children.push_back(cloneSubtree(atoms[best]));
+        factored->children.push_back(buildHorner(quotient));
+        if (rest.empty()) return factored;
+        Node* sum = new Node("+", true, false, false);
+        sum->children.push_back(factored);
+        sum->children.push_back(buildHorner(rest));
+        return sum;
+    }
+
+private:
+    Node* buildSum(std::vector<PolyTerm> live) {
+        if (live.empty()) return new Node("0", false, true, false);
+        // Першим іде додатний доданок, щоб не платити за унарний мінус
+        auto firstPositive = std::find_if(live.begin(), live.end(), [](const auto& t) { return t.coef > 0; });
+        if (firstPositive != live.end()) std::rotate(live.begin(), firstPositive, firstPositive + 1);
+
+        Node* acc = buildTerm(live[0].monomial, live[0].coef, true);
+        for (size_t i = 1; i < live.size(); ++i) {
+            Node* next = new Node(live[i].coef < 0 ? "-" : "+", true, false, false);
+            next->children.push_back(acc);
+            next->children.push_back(buildTerm(live[i].monomial, std::fabs(live[i].coef), false));
+            acc = next;
+        }
+        return acc;
+    }
+
+    int intern(Node* n, double& coef) {
+        std::string key;
+        if (n && !n->isOperator && !n->value.empty() && n->value[0] == '-') {
+            coef = -coef;
+            n->value.erase(0, 1);
+        }
+        if (n && !n->isOperator) {
+            key = n->value;
+        } else {
+            key = "(" + canonicalKey(n) + ")";
+        }
+        auto it = atomIds.find(key);
+        if (it != atomIds.end()) {
+            delete n;
+            return it->second;
+        }
+        int id = (int)atoms.size();
+        atoms.push_back(n);
+        atomIds.emplace(std::move(key), id);
+        return id;
+    }
+
+    // Ключ не залежить від порядку операндів + і *: (A+B)*C і C*(B+A) дають один множник
+    static std::string canonicalKey(Node* n) {
+        if (!n) return "_";
+        if (!n->isOperator) return n->value;
+        std::vector<std::string> parts;
+        if (n->value == "+" || n->value == "*") {
+            std::vector<Node*> stack = {n};
+            while (!stack.empty()) {
+                Node* c = stack.back();
+                stack.pop_back();
+                if (c && c->isOperator && c->value == n->value) stack.insert(stack.end(), c->children.begin(), c->children.end());
+                else parts.push_back(canonicalKey(c));
+            }
+            std::sort(parts.begin(), parts.end());
+        } else {
+            for (Node* child : n->children) parts.push_back(canonicalKey(child));
+        }
+        std::string key = n->value + "(";
+        for (size_t i = 0; i < parts.size(); ++i) {
+            if (i) key += ",";
+            key += parts[i];
+        }
+        return key + ")";
+    }
+
+    // signed: коефіцієнт зі знаком (лише для першого доданка), інакше — модуль
+    Node* buildTerm(const Monomial& m, double coef, bool signedCoef) {
+        bool negate = signedCoef && coef < 0;
+        double magnitude = std::fabs(coef);
+        if (m.empty()) return new Node(formatExactNumber(signedCoef ? coef : magnitude), false, true, false);
+        std::vector<Node*> factors;
+        for (int id : m) factors.push_back(cloneSubtree(atoms[id]));
+        if (magnitude != 1.0) {
+            factors.insert(factors.begin(), new Node(formatExactNumber(negate ? -magnitude : magnitude), false, true, false));
+            negate = false;
+        }
+        if (negate) {
+            Node* first = factors[0];
+            if (!first->isOperator) {
+                first->value = "-" + first->value;
+            } else {
+                factors.insert(factors.begin(), new Node("-1", false, true, false));
+            }
+        }
+        Node* acc = factors[0];
+        for (size_t i = 1; i < factors.size(); ++i) {
+            Node* next = new Node("*", true, false, false);
+            next->children.push_back(acc);
+            next->children.push_back(factors[i]);
+            acc = next;
+        }
+        return acc;
+    }
+
+    std::unordered_map<Monomial, Term, MonomialHash> terms;
+    std::unordered_map<std::string, int> atomIds;
+    std::vector<Node*> atoms;
+    Node* (*normalize)(Node*);
+};
+
+bool isSumNode(const Node* n) {
+    return n && n->isOperator && (n->value == "+" || n->value == "-") && n->children.size() == 2;
+}
+
+bool isProductNode(const Node* n) {
+    return n && n->isOperator && n->value == "*" && n->children.size() == 2;
+}
+
+int countOperations(const Node* root) {
+    int count = 0;
+    std::vector<const Node*> stack = {root};
+    while (!stack.empty()) {
+        const Node* n = stack.back();
+        stack.pop_back();
+        if (!n || !n->isOperator) continue;
+        ++count;
+        for (const Node* child : n->children) stack.push_back(child);
+    }
+    return count;
+}
+
+// Розбирає групу +/- під root і передає її доданки многочлену
+void collectGroup(Node* root, SparsePolynomial& poly) {
+    std::vector<std::pair<Node*, double>> stack = {{root, 1.0}};
+    std::vector<std::pair<Node*, double>> products;
+    while (!stack.empty()) {
+        auto [n, sign] = stack.back();
+        stack.pop_back();
+        if (isSumNode(n)) {
+            stack.push_back({n->children[1], n->value == "-" ? -sign : sign});
+            stack.push_back({n->children[0], sign});
+            n->children.clear();
+            delete n;
+        } else {
+            products.push_back({n, sign});
+        }
+    }
+    for (auto& [n, sign] : products) poly.addProduct(n, sign);
+}
+
+// Зважена робота: сума getOpDuration усіх операцій
+int weightedWork(const Node* root) {
+    int work = 0;
+    std::vector<const Node*> stack = {root};
+    while (!stack.empty()) {
+        const Node* n = stack.back();
+        stack.pop_back();
+        if (!n || !n->isOperator) continue;
+        work += getOpDuration(n->value);
+        for (const Node* child : n->children) stack.push_back(child);
+    }
+    return work;
+}
+
+// Перебудова без порівняння з вихідним деревом: вкладені групи розгортаються повністю,
+// щоб зовнішня бачила їхні множники (A+A -> 2*A), рішення приймає factorize
+Node* rebuildHorner(Node* node) {
+    if (!node || !node->isOperator) return node;
+    if (!isSumNode(node) && !isProductNode(node)) {
+        for (auto& child : node->children) child = rebuildHorner(child);
+        return node;
+    }
+    SparsePolynomial poly(rebuildHorner);
+    collectGroup(node, poly);
+    return poly.buildHorner(poly.liveTerms());
+}
+
+int countOperator(const Node* root, const std::string& op) {
+    int count = 0;
+    std::vector<const Node*> stack = {root};
+    while (!stack.empty()) {
+        const Node* n = stack.back();
+        stack.pop_back();
+        if (!n || !n->isOperator) continue;
+        if (n->value == op) ++count;
+        for (const Node* child : n->children) stack.push_back(child);
+    }
+    return count;
+}
+
+// Дерево як текст з явною структурою: treeToString не показує вузли без операндів
+std::string structureText(const Node* node) {
+    if (!node) return "null";
+    if (!node->isOperator) return node->value;
+    std::string text = node->value + "(";
+    for (size_t i = 0; i < node->children.size(); ++i) {
+        if (i) text += ",";
+        text += structureText(node->children[i]);
+    }
+    return text + ")";
+}
+
+std::vector<std::string> variableNames(const Node* root) {
+    std::vector<std::string> names;
+    std::vector<const Node*> stack = {root};
+    while (!stack.empty()) {
+        const Node* n = stack.back();
+        stack.pop_back();
+        if (!n) continue;
+        if (n->isVariable) names.push_back(n->value);
+        for (const Node* child : n->children) stack.push_back(child);
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+// Вирази, які раніше ламали canonicalizeChains. Без очікуваної структури перевіряється лише,
+// що пас завершується і не губить змінних
+void checkCanonicalChains() {
+    const std::pair<const char*, const char*> cases[] = {
+        {"-A+B", nullptr},                  // унарний мінус: була нескінченна рекурсія
+        {"A/3", "/(A,3)"},                  // 1/3 неточне — ділення лишається
+        {"X/7+Y/7", "+(/(X,7),/(Y,7))"},
+        {"A/10000000", "/(A,10000000)"},    // не 0*A
+        {"A*0.0000001", "*(0.0000001,A)"},  // стала не обрізається до 6 знаків
+        {"2+A+3+B+5", "+(+(A,B),10)"},
+        {"B*A/4*2", "*(*(0.5,A),B)"},       // 2/4 точне — згортається
+        {"6/4/A", "/(1.5,A)"},
+        {"A/0", "/(A,0)"},                  // ділення на нуль — для removeDivisionByZero
+    };
+    std::cout << "\n=== Constant reassociation: known hard inputs ===" << std::endl;
+    for (const auto& [input, expected] : cases) {
+        Node* tree = buildParseTree(input);
+        std::vector<std::string> names = variableNames(tree);
+        tree = canonicalizeChains(tree);
+        std::string actual = structureText(tree);
+        bool same = expected ? actual == expected : variableNames(tree) == names;
+        delete tree;
+        std::cout << std::setw(12) << input << " -> " << actual << (same ? "" : "  MISMATCH") << std::endl;
+    }
+}
+
+} // namespace
+
+namespace prsr {
+
+// Зведення подібних доданків: кожна сума добутків переводиться в розріджений многочлен
+// (хеш-таблиця одночлен -> коефіцієнт), протилежні доданки скорочуються.
+// Ланцюжки обходяться без рекурсії, тож суми з 10^5 доданків обробляються за O(n).
+Node* collectLikeTerms(Node* root) {
+    if (!root || !root->isOperator) return root;
+    if (!isSumNode(root) && !isProductNode(root)) {
+        for (auto& child : root->children) child = collectLikeTerms(child);
+        return root;
+    }
+    SparsePolynomial poly(collectLikeTerms);
+    collectGroup(root, poly);
+    return poly.build();
+}
+
+// Факторизація схемою Горнера: A*A*A*X+A*A*Y+A*Z+W -> A*(A*(A*X+Y)+Z)+W.
+// Одночлени порівнюються за хешем, множники — за канонічним ключем піддерева.
+// Перебудована група замінює вихідну лише тоді, коли зменшує зважену роботу.
+Node* factorize(Node* node) {
+    if (!node || !node->isOperator) return node;
+    if (!isSumNode(node) && !isProductNode(node)) {
+        for (auto& child : node->children) child = factorize(child);
+        return node;
+    }
+    Node* original = cloneSubtree(node);
+    Node* rebuilt = rebuildHorner(node);
+    if (weightedWork(rebuilt) < weightedWork(original)) {
+        delete original;
+        return rebuilt;
+    }
+    delete rebuilt;
+    return original;
+}
+
+// Кількість операцій і час нормалізації для сум з 10^3..10^5 доданків,
+// наприкінці — перевпорядкування сталих на відомих складних входах
+void benchmarkLikeTerms() {
+    std::mt19937 rng(42);
+    std::cout << "\n=== Like-term collection ===" << std::endl;
+    std::cout << "   Terms | ops before | ops after |   time, ms" << std::endl;
+    for (int termCount : {1000, 10000, 100000}) {
+        // Лівий ланцюжок, як його будує buildParseTree: ±X, ±X*Y, ±k*X
+        Node* tree = nullptr;
+        for (int i = 0; i < termCount; ++i) {
+            int shape = rng() % 3;
+            Node* term = new Node(std::string(1, char('A' + rng() % 26)), false, false, true);
+            if (shape > 0) {
+                Node* mul = new Node("*", true, false, false);
+                mul->children.push_back(shape == 1 ? new Node(std::string(1, char('A' + rng() % 26)), false, false, true)
+                                                   : new Node(std::to_string(1 + rng() % 5), false, true, false));
+                mul->children.push_back(term);
+                term = mul;
+            }
+            if (!tree) {
+                tree = term;
+                continue;
+            }
+            Node* sum = new Node(rng() % 2 ? "+" : "-", true, false, false);
+            sum->children.push_back(tree);
+            sum->children.push_back(term);
+            tree = sum;
+        }
+        int before = countOperations(tree);
+        auto t0 = std::chrono::steady_clock::now();
+        tree = collectLikeTerms(tree);
+        auto t1 = std::chrono::steady_clock::now();
+        std::cout << std::setw(8) << termCount << " | " << std::setw(10) << before << " | "
+                  << std::setw(9) << countOperations(tree) << " | " << std::fixed << std::setprecision(2)
+                  << std::setw(10) << std::chrono::duration<double, std::milli>(t1 - t0).count()
+                  << std::defaultfloat << std::setprecision(6) << std::endl;
+        delete tree;
+    }
+    checkCanonicalChains();
+}
+
+// === Звіт: вираз до і після факторизації схемою Горнера ===
+void modelFactoring(const std::string& expr, int procCount) {
+    if (!validateExpression(expr)) {
+        std::cout << "Error: the expression is not valid!" << std::endl;
+        return;
+    }
+    Node* before = buildOptimizedTree(expr);
+    if (!before) {
+        std::cout << "Error: failed to build the tree!" << std::endl;
+        return;
+    }
+    Node* after = factorize(cloneSubtree(before));
+    std::cout << "\n=== Horner factoring, " << procCount << " processors ===" << std::endl;
+    std::cout << "Before: " << treeToString(before) << std::endl;
+    std::cout << "After:  " << treeToString(after) << std::endl;
+    std::cout << "       | ops | +/- |  * |  / | work | critical path | makespan" << std::endl;
+    auto row = [&](const char* name, Node* tree) {
+        Node* scheduled = optimizeParallelTree(cloneSubtree(tree));
+        int makespan = 0;
+        for (const auto& t : assignTasksWithDependencies(scheduled, procCount)) makespan = std::max(makespan, t.endTime);
+        std::cout << std::setw(6) << name << " | " << std::setw(3) << countOperations(tree)
+                  << " | " << std::setw(3) << countOperator(tree, "+") + countOperator(tree, "-")
+                  << " | " << std::setw(2) << countOperator(tree, "*")
+                  << " | " << std::setw(2) << countOperator(tree, "/")
+                  << " | " << std::setw(4) << weightedWork(tree)
+                  << " | " << std::setw(13) << criticalPathLength(scheduled)
+                  << " | " << std::setw(8) << makespan << std::endl;
+        delete scheduled;
+    };
+    row("before", before);
+    row("after", after);
+    delete before;
+    delete after;
+}
+
+} // namespace prsr
@@ -0,0 +1,268 @@
+#include "parser.h"
+#include "modeling.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <queue>
+#include <set>
+#include <algorithm>
+
+int ResourceConfig::classFor(const std::string& op) const {
+    for (size_t c = 0; c < classes.size(); ++c) {
+        if (std::find(classes[c].ops.begin(), classes[c].ops.end(), op) != classes[c].ops.end()) return (int)c;
+    }
+    return -1;
+}
+
+int ResourceConfig::unitCount() const {
+    int total = 0;
+    for (const auto& c : classes) total += c.count;
+    return total;
+}
+
+// Опис блоків: "<кількість>x <ІМ'Я>[/<ІМ'Я>...][:латентність[:II]]" через кому.
+// Приклад: "2x ADD/SUB, 1x MUL:2:1, 1x DIV:4:2". Латентність за замовчуванням — з getOpDuration,
+// без II блок зайнятий на всю латентність.
+ResourceConfig parseResourceConfig(const std::string& spec) {
+    ResourceConfig config;
+    std::stringstream items(spec);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
+        if (item.empty()) continue;
+        size_t x = item.find_first_of("xX");
+        if (x == std::string::npos || x == 0) {
+            std::cout << "Error: invalid unit group '" << item << "'" << std::endl;
+            return {};
+        }
+        UnitClass unit;
+        try {
+            unit.count = std::stoi(item.substr(0, x));
+        } catch (...) {
+            std::cout << "Error: invalid unit count in '" << item << "'" << std::endl;
+            return {};
+        }
+        if (unit.count <= 0) {
+            std::cout << "Error: unit count must be positive in '" << item << "'" << std::endl;
+            return {};
+        }
+        std::string rest = item.substr(x + 1);
+        std::string latency;
+        size_t colon = rest.find(':');
+        if (colon != std::string::npos) {
+            latency = rest.substr(colon + 1);
+            rest = rest.substr(0, colon);
+        }
+        unit.name = rest;
+        std::stringstream names(rest);
+        std::string name;
+        unit.latency = 0;
+        while (std::getline(names, name, '/')) {
+            std::string op;
+            if (name == "ADD") op = "+";
+            else if (name == "SUB") op = "-";
+            else if (name == "MUL") op = "*";
+            else if (name == "DIV") op = "/";
+            else {
+                std::cout << "Error: unknown unit type '" << name << "'" << std::endl;
+                return {};
+            }
+            unit.ops.push_back(op);
+            unit.latency = std::max(unit.latency, getOpDuration(op));
+        }
+        if (!latency.empty()) {
+            try {
+                size_t ii = latency.find(':');
+                if (ii != std::string::npos) {
+                    unit.interval = std::max(1, std::stoi(latency.substr(ii + 1)));
+                    latency = latency.substr(0, ii);
+                }
+                unit.latency = std::max(1, std::stoi(latency));
+            } catch (...) {
+                std::cout << "Error: invalid latency in '" << item << "'" << std::endl;
+                return {};
+            }
+        }
+        config.classes.push_back(unit);
+    }
+    return config;
+}
+
+ResourceConfig withoutPipelining(const ResourceConfig& config) {
+    ResourceConfig plain = config;
+    for (auto& c : plain.classes) c.interval = 0;
+    return plain;
+}
+
+// Списочне планування з обмеженими ресурсами: готові операції за спаданням нижнього рівня
+// прив'язуються до вільного блока сумісного класу. Конвеєрний блок приймає наступну
+// операцію через II тактів, результат готовий через повну латентність.
+ResourceSchedule scheduleOnUnits(const TaskGraph& graph, const ResourceConfig& config) {
+    ResourceSchedule schedule;
+    size_t n = graph.size();
+    std::vector<int> cls(n), lat(n), issue(n);
+    for (size_t i = 0; i < n; ++i) {
+        cls[i] = config.classFor(graph.op(i));
+        if (cls[i] < 0 || config.classes[cls[i]].count <= 0) {
+            std::cout << "Error: no functional unit for operation '" << graph.op(i) << "'" << std::endl;
+            schedule.ok = false;
+            return schedule;
+        }
+        lat[i] = config.classes[cls[i]].latency;
+        issue[i] = config.classes[cls[i]].issueInterval();
+    }
+
+    // Нижні рівні з латентностями класів (пост-порядок: наступники мають більші індекси)
+    std::vector<int> level(n, 0);
+    for (int i = (int)n - 1; i >= 0; --i) {
+        int tail = 0;
+        for (int s : graph.succs(i)) tail = std::max(tail, level[s]);
+        level[i] = lat[i] + tail;
+        schedule.criticalPath = std::max(schedule.criticalPath, level[i]);
+    }
+
+    // Блоки нумеруються підряд по класах
+    std::vector<std::vector<int>> classUnits(config.classes.size());
+    for (size_t c = 0; c < config.classes.size(); ++c) {
+        for (int k = 0; k < config.classes[c].count; ++k) {
+            classUnits[c].push_back((int)schedule.unitClass.size());
+            schedule.unitClass.push_back((int)c);
+        }
+    }
+    std::vector<int> unitFree(schedule.unitClass.size(), 0);
+
+    using Ready = std::pair<int, int>;  // (нижній рівень, -задача)
+    std::vector<std::priority_queue<Ready>> ready(config.classes.size());
+    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<>> pending;
+    std::vector<int> remaining(n), readyAt(n, 0);
+    for (size_t i = 0; i < n; ++i) {
+        remaining[i] = graph.inDegree[i];
+        if (remaining[i] == 0) pending.push({0, (int)i});
+    }
+
+    size_t done = 0;
+    int t = 0;
+    while (done < n) {
+        while (!pending.empty() && pending.top().first <= t) {
+            int task = pending.top().second;
+            pending.pop();
+            ready[cls[task]].push({level[task], -task});
+        }
+        int next = INT_MAX;
+        for (size_t c = 0; c < config.classes.size(); ++c) {
+            for (int u : classUnits[c]) {
+                if (ready[c].empty()) break;
+                if (unitFree[u] > t) continue;
+                int task = -ready[c].top().second;
+                ready[c].pop();
+                int end = t + lat[task];
+                unitFree[u] = t + issue[task];
+                schedule.assignments.push_back({u, t, end, graph.op(task), task});
+                schedule.makespan = std::max(schedule.makespan, end);
+                ++done;
+                for (int s : graph.succs(task)) {
+                    readyAt[s] = std::max(readyAt[s], end);
+                    if (--remaining[s] == 0) pending.push({readyAt[s], s});
+                }
+            }
+            if (!ready[c].empty()) {
+                for (int u : classUnits[c]) next = std::min(next, std::max(unitFree[u], t + 1));
+            }
+        }
+        if (!pending.empty()) next = std::min(next, std::max(pending.top().first, t + 1));
+        if (next == INT_MAX) break;
+        t = next;
+    }
+
+    schedule.classes.assign(config.classes.size(), {});
+    for (const auto& a : schedule.assignments) {
+        auto& r = schedule.classes[schedule.unitClass[a.proc]];
+        r.ops++;
+        r.busy += config.classes[schedule.unitClass[a.proc]].issueInterval();
+    }
+    schedule.throughput = schedule.makespan > 0 ? (double)n / schedule.makespan : 0.0;
+    for (size_t c = 0; c < config.classes.size(); ++c) {
+        auto& r = schedule.classes[c];
+        int count = config.classes[c].count;
+        if (count <= 0) continue;  // порожній клас: межі немає, операцій на ньому теж
+        r.lowerBound = (r.busy + count - 1) / count;
+        r.utilization = schedule.makespan > 0 ? (double)r.busy / ((double)count * schedule.makespan) : 0.0;
+    }
+    return schedule;
+}
+
+void printResourceSchedule(const ResourceConfig& config, const ResourceSchedule& schedule) {
+    int seqTime = 0;
+    for (const auto& a : schedule.assignments) seqTime += a.endTime - a.startTime;
+    std::vector<TaskAssignment> occupancy = schedule.assignments;
+    for (auto& a : occupancy) a.endTime = a.startTime + config.classes[schedule.unitClass[a.proc]].issueInterval();
+    std::set<int> usedUnits;
+    for (const auto& a : schedule.assignments) usedUnits.insert(a.proc);
+    computeMetrics(seqTime, schedule.makespan, (int)usedUnits.size(), (int)schedule.unitClass.size());
+    std::cout << "Critical path (dependencies only): " << schedule.criticalPath << std::endl;
+    std::cout << "Throughput: " << schedule.throughput << " ops/cycle" << std::endl;
+
+    int bottleneck = -1;
+    std::cout << std::fixed << std::setprecision(1);
+    for (size_t c = 0; c < config.classes.size(); ++c) {
+        const auto& r = schedule.classes[c];
+        std::cout << config.classes[c].count << "x " << config.classes[c].name
+                  << " (latency " << config.classes[c].latency
+                  << ", II " << config.classes[c].issueInterval() << ")"
+                  << ": ops " << r.ops << ", busy " << r.busy
+                  << ", bound " << r.lowerBound
+                  << ", utilization " << r.utilization * 100.0 << "%" << std::endl;
+        if (bottleneck < 0 || r.lowerBound > schedule.classes[bottleneck].lowerBound) bottleneck = (int)c;
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+    if (bottleneck >= 0 && schedule.classes[bottleneck].lowerBound > schedule.criticalPath) {
+        std::cout << "Bottleneck: " << config.classes[bottleneck].name << " units" << std::endl;
+    } else {
+        std::cout << "Bottleneck: dependency chain (critical path)" << std::endl;
+    }
+
+    for (size_t u = 0; u < schedule.unitClass.size(); ++u) {
+        std::cout << "P" << u + 1 << " = " << config.classes[schedule.unitClass[u]].name << std::endl;
+    }
+    // Таблиця показує такти запуску: у конвеєрному блоці операції перекриваються
+    printGanttTable(occupancy, (int)schedule.unitClass.size());
+}
+
+// === Моделювання на функціональних блоках ===
+void prsr::modelFunctionalUnits(const std::string& expr, const std::string& unitSpec) {
+    if (!validateExpression(expr)) {
+        std::cout << "Error: the expression is not valid!" << std::endl;
+        return;
+    }
+    ResourceConfig config = parseResourceConfig(unitSpec);
+    if (config.classes.empty()) {
+        std::cout << "Error: the unit configuration is empty!" << std::endl;
+        return;
+    }
+    prsr::Node* tree = buildOptimizedTree(expr);
+    tree = prsr::optimizeParallelTree(tree);
+    if (!tree) {
+        std::cout << "Error: failed to build the tree!" << std::endl;
+        return;
+    }
+    TaskGraph graph = flattenTaskGraph(tree);
+    std::cout << "\n=== Functional units: " << unitSpec << " ===" << std::endl;
+    ResourceSchedule schedule = scheduleOnUnits(graph, config);
+    if (schedule.ok) printResourceSchedule(config, schedule);
+
+    bool pipelined = false;
+    for (const auto& c : config.classes) {
+        if (c.issueInterval() < c.latency) pipelined = true;
+    }
+    if (schedule.ok && pipelined) {
+        ResourceSchedule plain = scheduleOnUnits(graph, withoutPipelining(config));
+        std::cout << "\n--- Pipelined vs non-pipelined units ---" << std::endl;
+        std::cout << "Pipelined:     makespan " << schedule.makespan
+                  << ", throughput " << schedule.throughput << " ops/cycle" << std::endl;
+        std::cout << "Non-pipelined: makespan " << plain.makespan
+                  << ", throughput " << plain.throughput << " ops/cycle" << std::endl;
+    }
+    delete tree;
+}
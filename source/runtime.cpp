@@ -0,0 +1,216 @@
+#include "runtime.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+
+ReadyQueue::ReadyQueue(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) size <<= 1;
+    cells = std::make_unique<Cell[]>(size);
+    mask = size - 1;
+    for (size_t i = 0; i < size; ++i) cells[i].seq.store(i, std::memory_order_relaxed);
+}
+
+bool ReadyQueue::push(int task) {
+    size_t pos = tail.load(std::memory_order_relaxed);
+    while (true) {
+        Cell& cell = cells[pos & mask];
+        size_t seq = cell.seq.load(std::memory_order_acquire);
+        long long diff = (long long)seq - (long long)pos;
+        if (diff == 0) {
+            if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.task = task;
+                cell.seq.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;  // черга заповнена
+        } else {
+            pos = tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool ReadyQueue::pop(int& task) {
+    return popBatch(&task, 1) == 1;
+}
+
+size_t ReadyQueue::popBatch(int* out, size_t maxCount) {
+    size_t pos = head.load(std::memory_order_relaxed);
+    while (true) {
+        // Скільки комірок поспіль уже заповнені виробниками
+        size_t count = 0;
+        while (count < maxCount) {
+            size_t seq = cells[(pos + count) & mask].seq.load(std::memory_order_acquire);
+            if (seq != pos + count + 1) break;
+            ++count;
+        }
+        if (count == 0) {
+            size_t seq = cells[pos & mask].seq.load(std::memory_order_acquire);
+            if ((long long)seq - (long long)(pos + 1) < 0) return 0;  // черга порожня
+            pos = head.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (head.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+            for (size_t i = 0; i < count; ++i) {
+                Cell& cell = cells[(pos + i) & mask];
+                out[i] = cell.task;
+                cell.seq.store(pos + i + mask + 1, std::memory_order_release);
+            }
+            return count;
+        }
+    }
+}
+
+TaskRuntime::TaskRuntime(int threadCount, int batchSize)
+    : batchSize(std::max(1, batchSize)), queue(std::make_unique<ReadyQueue>(1024)) {
+    for (int i = 1; i < threadCount; ++i) threads.emplace_back(&TaskRuntime::helperLoop, this);
+}
+
+TaskRuntime::~TaskRuntime() {
+    stop.store(true, std::memory_order_release);
+    generation.fetch_add(1, std::memory_order_acq_rel);
+    generation.notify_all();
+    for (auto& t : threads) t.join();
+}
+
+void TaskRuntime::run(const RuntimeGraph& g, const std::function<void(int)>& fn) {
+    size_t n = g.size();
+    if (n == 0) return;
+    graph = &g;
+    body = &fn;
+    // Кожна задача потрапляє в чергу не більше одного разу, тож переповнення неможливе
+    if (queue->capacity() < n) queue = std::make_unique<ReadyQueue>(n);
+    if (pendingSize < n) {
+        pending = std::make_unique<PaddedCounter[]>(n);
+        pendingSize = n;
+    }
+    for (size_t i = 0; i < n; ++i) pending[i].value.store(g.inDegree[i], std::memory_order_relaxed);
+    remaining.store((long long)n, std::memory_order_release);
+    for (size_t i = 0; i < n; ++i) {
+        if (g.inDegree[i] == 0) queue->push((int)i);
+    }
+    generation.fetch_add(1, std::memory_order_acq_rel);
+    generation.notify_all();
+    work();
+    // Помічники мають вийти з задачі, перш ніж граф можна буде звільнити
+    while (active.load(std::memory_order_acquire) != 0) std::this_thread::yield();
+}
+
+void TaskRuntime::helperLoop() {
+    unsigned seen = 0;
+    while (true) {
+        generation.wait(seen, std::memory_order_acquire);
+        seen = generation.load(std::memory_order_acquire);
+        if (stop.load(std::memory_order_acquire)) return;
+        active.fetch_add(1, std::memory_order_acq_rel);
+        work();
+        active.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+// Виконує задачу і далі — ланцюжок наступників, що стали готовими саме в цьому потоці
+size_t TaskRuntime::runChain(int task) {
+    size_t executed = 0;
+    while (task >= 0) {
+        (*body)(task);
+        ++executed;
+        int next = -1;
+        for (int k = graph->succStart[task]; k < graph->succStart[task + 1]; ++k) {
+            int s = graph->succList[k];
+            if (pending[s].value.fetch_sub(1, std::memory_order_acq_rel) != 1) continue;
+            if (next < 0) next = s;
+            else queue->push(s);
+        }
+        task = next;
+    }
+    return executed;
+}
+
+void TaskRuntime::work() {
+    std::vector<int> batch(batchSize);
+    int idle = 0;
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        size_t got = queue->popBatch(batch.data(), batch.size());
+        if (got == 0) {
+            if (++idle > 64) std::this_thread::yield();
+            continue;
+        }
+        idle = 0;
+        size_t executed = 0;
+        for (size_t i = 0; i < got; ++i) executed += runChain(batch[i]);
+        // Один атомарний декремент на пакет, а не на кожну задачу
+        remaining.fetch_sub((long long)executed, std::memory_order_acq_rel);
+    }
+}
+
+namespace {
+
+// Незалежні задачі: вимірює лише пропускну здатність черги
+RuntimeGraph makeFlatGraph(int taskCount) {
+    RuntimeGraph g;
+    g.inDegree.assign(taskCount, 0);
+    g.succStart.assign(taskCount + 1, 0);
+    return g;
+}
+
+// Збалансоване бінарне дерево редукції: листки 0..leaves-1, далі внутрішні вузли
+RuntimeGraph makeReductionGraph(int taskCount) {
+    int leaves = std::max(1, (taskCount + 1) / 2);
+    int n = 2 * leaves - 1;
+    RuntimeGraph g;
+    g.inDegree.assign(n, 0);
+    std::vector<int> parent(n, -1);
+    std::vector<int> level(leaves);
+    for (int i = 0; i < leaves; ++i) level[i] = i;
+    int next = leaves;
+    while (level.size() > 1) {
+        std::vector<int> up;
+        for (size_t i = 0; i + 1 < level.size(); i += 2) {
+            parent[level[i]] = parent[level[i + 1]] = next;
+            g.inDegree[next] = 2;
+            up.push_back(next++);
+        }
+        if (level.size() % 2) up.push_back(level.back());
+        level = up;
+    }
+    g.succStart.assign(n + 1, 0);
+    for (int i = 0; i < n; ++i) g.succStart[i + 1] = g.succStart[i] + (parent[i] >= 0 ? 1 : 0);
+    for (int i = 0; i < n; ++i) {
+        if (parent[i] >= 0) g.succList.push_back(parent[i]);
+    }
+    return g;
+}
+
+double measureTasksPerSecond(const RuntimeGraph& g, int threads, int batchSize, int repeat) {
+    TaskRuntime runtime(threads, batchSize);
+    std::vector<double> values(g.size(), 1.0);
+    std::function<void(int)> body = [&](int task) { values[task] += 1.0; };
+    runtime.run(g, body);  // прогрів
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeat; ++r) runtime.run(g, body);
+    auto t1 = std::chrono::steady_clock::now();
+    double sec = std::chrono::duration<double>(t1 - t0).count();
+    return sec > 0 ? (double)g.size() * repeat / sec : 0.0;
+}
+
+} // namespace
+
+void benchmarkRuntime(int taskCount, int maxThreads) {
+    const int repeat = 20;
+    RuntimeGraph flat = makeFlatGraph(taskCount);
+    RuntimeGraph tree = makeReductionGraph(taskCount);
+    std::cout << "Runtime benchmark: " << taskCount << " tasks of one addition, " << repeat << " runs" << std::endl;
+    std::cout << "Threads | independent, batch 1 | independent, batch 16 | reduction tree, batch 16" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        std::cout << std::setw(7) << threads
+                  << " | " << std::setw(15) << measureTasksPerSecond(flat, threads, 1, repeat) / 1e6 << " M/s"
+                  << " | " << std::setw(16) << measureTasksPerSecond(flat, threads, 16, repeat) / 1e6 << " M/s"
+                  << " | " << std::setw(19) << measureTasksPerSecond(tree, threads, 16, repeat) / 1e6 << " M/s"
+                  << std::endl;
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+    std::cout << "Hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Розмір рядка кешу: сусідні лічильники не повинні ділити один рядок (false sharing)
+constexpr size_t kCacheLine = 64;
+
+// Лічильник вхідних залежностей вузла, вирівняний на рядок кешу
+struct alignas(kCacheLine) PaddedCounter {
+    std::atomic<int> value{0};
+};
+
+// Обмежена lock-free черга MPMC (схема Вьюкова): кожна комірка має номер послідовності,
+// виробники і споживачі захоплюють позиції через CAS на head/tail
+class ReadyQueue {
+public:
+    explicit ReadyQueue(size_t capacity);
+
+    size_t capacity() const { return mask + 1; }
+    bool push(int task);
+    bool pop(int& task);
+    // Забирає до maxCount підряд готових задач одним CAS
+    size_t popBatch(int* out, size_t maxCount);
+
+private:
+    struct Cell {
+        std::atomic<size_t> seq;
+        int task;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(kCacheLine) std::atomic<size_t> tail{0};
+    alignas(kCacheLine) std::atomic<size_t> head{0};
+};
+
+// Граф для виконання у форматі CSR: наступники вузла i — succList[succStart[i]..succStart[i+1])
+struct RuntimeGraph {
+    std::vector<int> succStart;
+    std::vector<int> succList;
+    std::vector<int> inDegree;
+
+    size_t size() const { return inDegree.size(); }
+};
+
+// Пул потоків для графів задач без блокувань: готові задачі роздаються через ReadyQueue,
+// перший готовий наступник виконується тим самим потоком без черги.
+// Викликаючий потік — робітник 0.
+class TaskRuntime {
+public:
+    TaskRuntime(int threadCount, int batchSize = 16);
+    ~TaskRuntime();
+
+    int threadCount() const { return (int)threads.size() + 1; }
+    // body(task) викликається рівно один раз для кожної задачі після всіх її попередників
+    void run(const RuntimeGraph& graph, const std::function<void(int)>& body);
+
+private:
+    void helperLoop();
+    void work();
+    size_t runChain(int task);
+
+    std::vector<std::thread> threads;
+    int batchSize;
+    std::unique_ptr<ReadyQueue> queue;
+    std::unique_ptr<PaddedCounter[]> pending;
+    size_t pendingSize = 0;
+    const RuntimeGraph* graph = nullptr;
+    const std::function<void(int)>* body = nullptr;
+    alignas(kCacheLine) std::atomic<long long> remaining{0};
+    alignas(kCacheLine) std::atomic<int> active{0};
+    alignas(kCacheLine) std::atomic<unsigned> generation{0};
+    std::atomic<bool> stop{false};
+};
+
+// Мікробенчмарк: задачі з однією операцією додавання, задач/с залежно від кількості потоків
+void benchmarkRuntime(int taskCount, int maxThreads);
@@ -0,0 +1,169 @@
+#include "parser.h"
+#include "modeling.h"
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+// Машина без процесорів — ознака помилки в описі
+MachineModel emptyMachine() {
+    MachineModel machine;
+    machine.procCount = 0;
+    return machine;
+}
+
+} // namespace
+
+// Опис машини: групи "<кількість>x<швидкість> [op=тривалість ...]" через кому, плюс "comm=<затримка>".
+// Приклад: "2x2.0, 4x1.0 /=12, comm=0.5" — два швидкі ядра і чотири базові без апаратного ділення.
+MachineModel parseMachineSpec(const std::string& spec) {
+    MachineModel machine = emptyMachine();
+    try {
+        std::stringstream groups(spec);
+        std::string group;
+        while (std::getline(groups, group, ',')) {
+            std::stringstream words(group);
+            std::string word;
+            if (!(words >> word)) continue;
+            if (word.rfind("comm=", 0) == 0) {
+                machine.commLatency = std::stod(word.substr(5));
+                continue;
+            }
+            size_t x = word.find('x');
+            if (x == std::string::npos || x == 0) {
+                std::cout << "Error: invalid machine group '" << word << "'" << std::endl;
+                return emptyMachine();
+            }
+            int count = std::stoi(word.substr(0, x));
+            double speed = x + 1 < word.size() ? std::stod(word.substr(x + 1)) : 1.0;
+            std::map<std::string, double> overrides;
+            while (words >> word) {
+                size_t eq = word.find('=');
+                if (eq == std::string::npos || eq == 0) {
+                    std::cout << "Error: invalid operation override '" << word << "'" << std::endl;
+                    return emptyMachine();
+                }
+                overrides[word.substr(0, eq)] = std::stod(word.substr(eq + 1));
+            }
+            for (int i = 0; i < count; ++i) {
+                machine.speed.push_back(speed);
+                machine.opOverride.push_back(overrides);
+            }
+            machine.procCount += count;
+        }
+    } catch (...) {
+        std::cout << "Error: invalid number in machine description '" << spec << "'" << std::endl;
+        return emptyMachine();
+    }
+    return machine;
+}
+
+// Висхідний ранг HEFT: середня тривалість задачі + найдовший хвіст до виходу
+std::vector<double> upwardRanks(const TaskGraph& graph, const MachineModel& machine) {
+    std::vector<double> rank(graph.size(), 0.0);
+    // Пост-порядок: наступники мають більші індекси
+    for (int i = (int)graph.size() - 1; i >= 0; --i) {
+        double avg = 0.0;
+        for (int p = 0; p < machine.procCount; ++p) avg += machine.opDuration(graph.op(i), p);
+        avg /= std::max(1, machine.procCount);
+        double tail = 0.0;
+        for (int s : graph.succs(i)) tail = std::max(tail, machine.commLatency + rank[s]);
+        rank[i] = avg + tail;
+    }
+    return rank;
+}
+
+// HEFT: задачі за спаданням рангу, кожна — на процесор з найменшим часом завершення
+// (з урахуванням вставки у проміжки простою)
+SimResult scheduleHEFT(const TaskGraph& graph, const MachineModel& machine) {
+    SimResult result;
+    size_t n = graph.size();
+    if (n == 0 || machine.procCount <= 0) return result;
+
+    std::vector<double> rank = upwardRanks(graph, machine);
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return rank[a] > rank[b]; });
+
+    struct Slot { double start; double end; };
+    std::vector<std::vector<Slot>> timeline(machine.procCount);
+    std::vector<double> finish(n, 0.0);
+    std::vector<int> proc(n, -1);
+    result.procBusy.assign(machine.procCount, 0.0);
+
+    for (int task : order) {
+        int bestProc = 0;
+        double bestStart = 0.0, bestFinish = 0.0;
+        for (int p = 0; p < machine.procCount; ++p) {
+            double ready = 0.0;
+            for (int pr : graph.preds(task)) {
+                ready = std::max(ready, finish[pr] + (proc[pr] == p ? 0.0 : machine.commLatency));
+            }
+            double dur = machine.opDuration(graph.op(task), p);
+            // Найраніший проміжок на процесорі, куди вміщується задача
+            double start = ready;
+            for (const Slot& s : timeline[p]) {
+                if (start + dur <= s.start) break;
+                start = std::max(start, s.end);
+            }
+            if (p == 0 || start + dur < bestFinish) {
+                bestProc = p;
+                bestStart = start;
+                bestFinish = start + dur;
+            }
+        }
+        auto& slots = timeline[bestProc];
+        auto pos = std::upper_bound(slots.begin(), slots.end(), bestStart,
+            [](double t, const Slot& s) { return t < s.start; });
+        slots.insert(pos, {bestStart, bestFinish});
+        finish[task] = bestFinish;
+        proc[task] = bestProc;
+        result.trace.push_back({task, bestProc, bestStart, bestFinish});
+        result.procBusy[bestProc] += bestFinish - bestStart;
+        result.makespan = std::max(result.makespan, bestFinish);
+    }
+    for (double b : result.procBusy) {
+        if (b > 0.0) result.usedProcs++;
+    }
+    result.seqTime = fastestSingleProcTime(graph, machine);
+    return result;
+}
+
+// === Моделювання на гетерогенній машині: HEFT проти списочного планування ===
+void prsr::modelHeterogeneousSystem(const std::string& expr, const std::string& machineSpec) {
+    if (!validateExpression(expr)) {
+        std::cout << "Error: the expression is not valid!" << std::endl;
+        return;
+    }
+    MachineModel machine = parseMachineSpec(machineSpec);
+    if (machine.procCount <= 0) {
+        std::cout << "Error: the machine description is empty!" << std::endl;
+        return;
+    }
+    prsr::Node* tree = buildOptimizedTree(expr);
+    tree = prsr::optimizeParallelTree(tree);
+    if (!tree) {
+        std::cout << "Error: failed to build the tree!" << std::endl;
+        return;
+    }
+    TaskGraph graph = flattenTaskGraph(tree);
+
+    std::cout << "\n=== Homogeneous plan replayed on the heterogeneous machine ===" << std::endl;
+    auto plan = assignTasksWithDependencies(tree, machine.procCount);
+    printSimResult(graph, simulateSchedule(graph, machine, plan), machine.procCount);
+
+    std::cout << "\n=== HEFT on " << machine.procCount << " heterogeneous processors ===" << std::endl;
+    SimResult heft = scheduleHEFT(graph, machine);
+    printSimResult(graph, heft, machine.procCount);
+
+    // Перевірка: той самий план, виконаний подійним симулятором
+    SimResult replayed = simulateSchedule(graph, machine, traceToPlan(graph, heft.trace), false);
+    std::cout << "HEFT plan replayed by the simulator: makespan " << replayed.makespan << std::endl;
+    std::cout << "Speedup vs fastest single processor: " << heft.seqTime / heft.makespan << std::endl;
+
+    delete tree;
+}
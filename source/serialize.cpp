@@ -0,0 +1,496 @@
+#include "serialize.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <unordered_map>
+
+namespace {
+
+// Код вузла в прямому порядку. Бінарні +,-,*,/ і змінні з перших 240 рядків таблиці
+// займають один байт; решта вузлів — код і кілька varint.
+enum TreeOp : uint8_t {
+    OpNull = 0,
+    OpAdd = 1,
+    OpSub = 2,
+    OpMul = 3,
+    OpDiv = 4,
+    OpInt = 5,       // zigzag varint
+    OpDouble = 6,    // 8 байт
+    OpGeneric = 7,   // прапорці, індекс рядка, кількість дітей
+    OpVarIndex = 8,  // індекс рядка varint
+    OpVar = 16       // 16 + індекс рядка
+};
+
+const uint32_t kInlineVars = 256 - OpVar;
+
+enum GenericFlags : uint8_t { FlagOperator = 1, FlagNumber = 2, FlagVariable = 4 };
+
+void putVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out += char((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    out += char(value);
+}
+
+uint64_t zigzag(long long value) { return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63); }
+long long unzigzag(uint64_t value) { return (long long)(value >> 1) ^ -(long long)(value & 1); }
+
+bool getVarint(const char* data, size_t size, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= size) return false;
+        uint8_t byte = (uint8_t)data[pos++];
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+bool getInt(const char* data, size_t size, size_t& pos, long long& value) {
+    uint64_t raw = 0;
+    if (!getVarint(data, size, pos, raw)) return false;
+    value = unzigzag(raw);
+    return true;
+}
+
+class StringTable {
+public:
+    uint32_t intern(const std::string& s) {
+        auto it = index.find(s);
+        if (it != index.end()) return it->second;
+        uint32_t id = (uint32_t)order.size();
+        index.emplace(s, id);
+        order.push_back(&index.find(s)->first);
+        return id;
+    }
+
+    void write(std::string& out) const {
+        putVarint(out, order.size());
+        for (const std::string* s : order) {
+            putVarint(out, s->size());
+            out += *s;
+        }
+    }
+
+private:
+    std::unordered_map<std::string, uint32_t> index;
+    std::vector<const std::string*> order;
+};
+
+void writeHeader(std::string& out, char kind, uint8_t version) {
+    out += 'C';
+    out += kind;
+    out += char(version);
+    out += char(0);
+}
+
+// Заголовок і таблиця рядків; body — зміщення першого запису після лічильника записів
+bool readPrefix(const char* data, size_t size, char kind, uint8_t version, std::vector<std::string_view>& strings,
+                size_t& count, size_t& body) {
+    if (!data || size < 4 || data[0] != 'C' || data[1] != kind || (uint8_t)data[2] != version) return false;
+    size_t pos = 4;
+    uint64_t stringCount = 0, records = 0;
+    if (!getVarint(data, size, pos, stringCount) || stringCount > size) return false;
+    strings.clear();
+    strings.reserve((size_t)stringCount);
+    for (uint64_t i = 0; i < stringCount; ++i) {
+        uint64_t length = 0;
+        if (!getVarint(data, size, pos, length) || length > size - pos) return false;
+        strings.emplace_back(data + pos, (size_t)length);
+        pos += (size_t)length;
+    }
+    if (!getVarint(data, size, pos, records) || records > size) return false;
+    count = (size_t)records;
+    body = pos;
+    return true;
+}
+
+bool isIntegralText(const std::string& text, double value, long long& out) {
+    if (value != std::floor(value) || std::fabs(value) > 9007199254740992.0) return false;
+    out = (long long)value;
+    return std::to_string(out) == text;
+}
+
+void encodeNode(const prsr::Node* n, StringTable& strings, std::string& out) {
+    if (!n) {
+        out += char(OpNull);
+        return;
+    }
+    bool plain = !n->isNumber && !n->isVariable;
+    if (n->isOperator && plain && n->children.size() == 2 && n->value.size() == 1) {
+        switch (n->value[0]) {
+            case '+': out += char(OpAdd); return;
+            case '-': out += char(OpSub); return;
+            case '*': out += char(OpMul); return;
+            case '/': out += char(OpDiv); return;
+        }
+    }
+    if (!n->isOperator && n->children.empty()) {
+        if (n->isVariable && !n->isNumber) {
+            uint32_t id = strings.intern(n->value);
+            if (id < kInlineVars) {
+                out += char(OpVar + id);
+            } else {
+                out += char(OpVarIndex);
+                putVarint(out, id);
+            }
+            return;
+        }
+        if (n->isNumber && !n->isVariable && !n->value.empty()) {
+            char* end = nullptr;
+            double value = std::strtod(n->value.c_str(), &end);
+            long long integral = 0;
+            if (*end == '\0' && isIntegralText(n->value, value, integral)) {
+                out += char(OpInt);
+                putVarint(out, zigzag(integral));
+                return;
+            }
+            if (*end == '\0' && prsr::formatNumber(value) == n->value) {
+                out += char(OpDouble);
+                out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+                return;
+            }
+        }
+    }
+    out += char(OpGeneric);
+    out += char((n->isOperator ? FlagOperator : 0) | (n->isNumber ? FlagNumber : 0) | (n->isVariable ? FlagVariable : 0));
+    putVarint(out, strings.intern(n->value));
+    putVarint(out, n->children.size());
+}
+
+} // namespace
+
+// === Дерево ===
+std::string serializeTree(const prsr::Node* root) {
+    StringTable strings;
+    std::string body;
+    size_t count = 0;
+    std::vector<const prsr::Node*> stack = {root};
+    while (!stack.empty()) {
+        const prsr::Node* n = stack.back();
+        stack.pop_back();
+        encodeNode(n, strings, body);
+        ++count;
+        if (n) for (auto it = n->children.rbegin(); it != n->children.rend(); ++it) stack.push_back(*it);
+    }
+    std::string out;
+    writeHeader(out, 'T', kTreeFormatVersion);
+    strings.write(out);
+    putVarint(out, count);
+    out += body;
+    return out;
+}
+
+bool TreeView::open(const char* buffer, size_t length) {
+    data = buffer;
+    size = length;
+    if (readPrefix(buffer, length, 'T', kTreeFormatVersion, strings, count, body)) return true;
+    data = nullptr;
+    count = 0;
+    return false;
+}
+
+TreeView::Cursor TreeView::begin() const {
+    Cursor c;
+    c.view = this;
+    c.pos = body;
+    c.left = data ? count : 0;
+    return c;
+}
+
+bool TreeView::Cursor::next(TreeNodeRef& node) {
+    if (bad || left == 0) return false;
+    const char* data = view->data;
+    size_t size = view->size;
+    bad = true;
+    if (pos >= size) return false;
+    uint8_t op = (uint8_t)data[pos++];
+    node = TreeNodeRef();
+    static const char* kBinary[] = {"+", "-", "*", "/"};
+    if (op == OpNull) {
+        node.isNull = true;
+    } else if (op >= OpAdd && op <= OpDiv) {
+        node.isOperator = true;
+        node.children = 2;
+        node.value = kBinary[op - OpAdd];
+    } else if (op == OpInt) {
+        long long value = 0;
+        if (!getInt(data, size, pos, value)) return false;
+        node.isNumber = true;
+        node.number = (double)value;
+    } else if (op == OpDouble) {
+        if (size - pos < sizeof(double)) return false;
+        std::memcpy(&node.number, data + pos, sizeof(double));
+        pos += sizeof(double);
+        node.isNumber = true;
+    } else if (op == OpGeneric) {
+        if (pos >= size) return false;
+        uint8_t flags = (uint8_t)data[pos++];
+        uint64_t id = 0, children = 0;
+        if (!getVarint(data, size, pos, id) || id >= view->strings.size() ||
+            !getVarint(data, size, pos, children) || children > size) {
+            return false;
+        }
+        node.isOperator = flags & FlagOperator;
+        node.isNumber = flags & FlagNumber;
+        node.isVariable = flags & FlagVariable;
+        node.value = view->strings[(size_t)id];
+        node.children = (uint32_t)children;
+    } else {
+        uint64_t id = op - OpVar;
+        if (op == OpVarIndex && !getVarint(data, size, pos, id)) return false;
+        if ((op != OpVarIndex && op < OpVar) || id >= view->strings.size()) return false;
+        node.isVariable = true;
+        node.value = view->strings[(size_t)id];
+    }
+    bad = false;
+    --left;
+    return true;
+}
+
+bool TreeView::materialize(prsr::Node*& root) const {
+    root = nullptr;
+    std::vector<prsr::Node*> parents;
+    std::vector<uint32_t> pending;
+    Cursor cursor = begin();
+    TreeNodeRef ref;
+    bool rootSeen = false;
+    while (cursor.next(ref)) {
+        prsr::Node* n = nullptr;
+        if (!ref.isNull) {
+            std::string value(ref.value);
+            // Числа, закодовані як число, отримують той самий текст, що й до кодування
+            if (ref.isNumber && value.empty()) {
+                value = ref.number == std::floor(ref.number) && std::fabs(ref.number) <= 9007199254740992.0
+                            ? std::to_string((long long)ref.number)
+                            : prsr::formatNumber(ref.number);
+            }
+            n = new prsr::Node(value, ref.isOperator, ref.isNumber, ref.isVariable);
+        }
+        if (parents.empty()) {
+            if (rootSeen) {
+                delete n;
+                delete root;
+                root = nullptr;
+                return false;
+            }
+            root = n;
+            rootSeen = true;
+        } else {
+            parents.back()->children.push_back(n);
+            --pending.back();
+        }
+        if (n && ref.children > 0) {
+            parents.push_back(n);
+            pending.push_back(ref.children);
+        }
+        while (!pending.empty() && pending.back() == 0) {
+            parents.pop_back();
+            pending.pop_back();
+        }
+    }
+    if (cursor.failed() || !parents.empty() || !rootSeen) {
+        delete root;
+        root = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool deserializeTree(const char* data, size_t size, prsr::Node*& root) {
+    root = nullptr;
+    TreeView view;
+    if (!view.open(data, size)) return false;
+    return view.materialize(root);
+}
+
+// === План ===
+// Запис: процесор, зсув початку від попереднього запису, тривалість, операція, зсув номера задачі
+std::string serializeSchedule(const std::vector<TaskAssignment>& assignments) {
+    StringTable strings;
+    std::string body;
+    long long start = 0, task = -1;
+    for (const auto& t : assignments) {
+        putVarint(body, zigzag(t.proc));
+        putVarint(body, zigzag((long long)t.startTime - start));
+        putVarint(body, zigzag((long long)t.endTime - t.startTime));
+        putVarint(body, strings.intern(t.op));
+        putVarint(body, zigzag((long long)t.task - task - 1));
+        start = t.startTime;
+        task = t.task;
+    }
+    std::string out;
+    writeHeader(out, 'S', kScheduleFormatVersion);
+    strings.write(out);
+    putVarint(out, assignments.size());
+    out += body;
+    return out;
+}
+
+bool ScheduleView::open(const char* buffer, size_t length) {
+    data = buffer;
+    bytes = length;
+    if (readPrefix(buffer, length, 'S', kScheduleFormatVersion, strings, count, body)) return true;
+    data = nullptr;
+    count = 0;
+    return false;
+}
+
+ScheduleView::Cursor ScheduleView::begin() const {
+    Cursor c;
+    c.view = this;
+    c.pos = body;
+    c.left = data ? count : 0;
+    return c;
+}
+
+bool ScheduleView::Cursor::next(TaskAssignmentRef& assignment) {
+    if (bad || left == 0) return false;
+    const char* data = view->data;
+    size_t size = view->bytes;
+    long long proc = 0, startDelta = 0, duration = 0, taskDelta = 0;
+    uint64_t op = 0;
+    bad = true;
+    if (!getInt(data, size, pos, proc) || !getInt(data, size, pos, startDelta) || !getInt(data, size, pos, duration) ||
+        !getVarint(data, size, pos, op) || !getInt(data, size, pos, taskDelta) || op >= view->strings.size()) {
+        return false;
+    }
+    start += startDelta;
+    task += taskDelta + 1;
+    long long end = start + duration;
+    auto fits = [](long long v) { return v >= INT_MIN && v <= INT_MAX; };
+    if (!fits(proc) || !fits(start) || !fits(end) || !fits(task)) return false;
+    assignment = {(int)proc, (int)start, (int)end, (int)task, view->strings[(size_t)op]};
+    bad = false;
+    --left;
+    return true;
+}
+
+bool deserializeSchedule(const char* data, size_t size, std::vector<TaskAssignment>& assignments) {
+    assignments.clear();
+    ScheduleView view;
+    if (!view.open(data, size)) return false;
+    assignments.reserve(view.size());
+    ScheduleView::Cursor cursor = view.begin();
+    TaskAssignmentRef ref;
+    while (cursor.next(ref)) {
+        TaskAssignment t;
+        t.proc = ref.proc;
+        t.startTime = ref.startTime;
+        t.endTime = ref.endTime;
+        t.op = std::string(ref.op);
+        t.task = ref.task;
+        assignments.push_back(std::move(t));
+    }
+    return !cursor.failed() && assignments.size() == view.size();
+}
+
+namespace {
+
+// Збалансоване дерево з leafCount листків: змінні A..Z, іноді числа
+prsr::Node* randomTree(std::mt19937& rng, int leafCount) {
+    if (leafCount == 1) {
+        if (rng() % 8 == 0) return new prsr::Node(std::to_string(rng() % 100), false, true, false);
+        if (rng() % 16 == 0) return new prsr::Node(prsr::formatNumber((rng() % 1000) / 8.0), false, true, false);
+        return new prsr::Node(std::string(1, char('A' + rng() % 26)), false, false, true);
+    }
+    static const char* kOps[] = {"+", "-", "*", "/"};
+    prsr::Node* n = new prsr::Node(kOps[rng() % 4], true);
+    n->children = {randomTree(rng, leafCount / 2), randomTree(rng, leafCount - leafCount / 2)};
+    return n;
+}
+
+bool sameTree(const prsr::Node* a, const prsr::Node* b) {
+    std::vector<std::pair<const prsr::Node*, const prsr::Node*>> stack = {{a, b}};
+    while (!stack.empty()) {
+        auto [x, y] = stack.back();
+        stack.pop_back();
+        if (!x || !y) {
+            if (x != y) return false;
+            continue;
+        }
+        if (x->value != y->value || x->isOperator != y->isOperator || x->isNumber != y->isNumber ||
+            x->isVariable != y->isVariable || x->children.size() != y->children.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < x->children.size(); ++i) stack.push_back({x->children[i], y->children[i]});
+    }
+    return true;
+}
+
+double gbPerSecond(size_t bytes, double seconds) { return seconds > 0 ? bytes / seconds / 1e9 : 0.0; }
+
+} // namespace
+
+// === Кодування туди й назад: байтів на вузол, пропускна здатність ===
+void prsr::benchmarkSerialization() {
+    std::mt19937 rng(7);
+    std::cout << "\n=== Binary serialization round trip ===" << std::endl;
+    std::cout << "  Nodes | text B/node | binary B/node | encode GB/s | decode GB/s | view GB/s | round trip" << std::endl;
+    for (int leaves : {1000, 100000, 1000000}) {
+        prsr::Node* tree = randomTree(rng, leaves);
+        size_t nodes = 2 * (size_t)leaves - 1;
+        const int repeat = leaves >= 1000000 ? 3 : 20;
+        auto t0 = std::chrono::steady_clock::now();
+        std::string blob;
+        for (int i = 0; i < repeat; ++i) blob = serializeTree(tree);
+        auto t1 = std::chrono::steady_clock::now();
+        prsr::Node* copy = nullptr;
+        for (int i = 0; i < repeat; ++i) {
+            delete copy;
+            deserializeTree(blob.data(), blob.size(), copy);
+        }
+        auto t2 = std::chrono::steady_clock::now();
+        // Перегляд без побудови вузлів: лише прохід курсором
+        size_t operators = 0;
+        for (int i = 0; i < repeat; ++i) {
+            TreeView view;
+            view.open(blob.data(), blob.size());
+            TreeView::Cursor cursor = view.begin();
+            TreeNodeRef ref;
+            while (cursor.next(ref)) operators += ref.isOperator;
+        }
+        auto t3 = std::chrono::steady_clock::now();
+        size_t textBytes = treeToString(tree).size();
+        size_t total = blob.size() * repeat;
+        std::cout << std::setw(7) << nodes << " | " << std::fixed << std::setprecision(2) << std::setw(11)
+                  << (double)textBytes / nodes << " | " << std::setw(13) << (double)blob.size() / nodes
+                  << " | " << std::setw(11) << gbPerSecond(total, std::chrono::duration<double>(t1 - t0).count())
+                  << " | " << std::setw(11) << gbPerSecond(total, std::chrono::duration<double>(t2 - t1).count())
+                  << " | " << std::setw(9) << gbPerSecond(total, std::chrono::duration<double>(t3 - t2).count())
+                  << " | " << (sameTree(tree, copy) && operators == (nodes - leaves) * repeat ? "ok" : "MISMATCH")
+                  << std::defaultfloat << std::setprecision(6) << std::endl;
+        delete copy;
+        delete tree;
+    }
+
+    prsr::Node* tree = randomTree(rng, 4000);
+    std::vector<TaskAssignment> plan = assignTasksWithDependencies(tree, 8);
+    delete tree;
+    const int repeat = 200;
+    auto t0 = std::chrono::steady_clock::now();
+    std::string blob;
+    for (int i = 0; i < repeat; ++i) blob = serializeSchedule(plan);
+    auto t1 = std::chrono::steady_clock::now();
+    std::vector<TaskAssignment> copy;
+    for (int i = 0; i < repeat; ++i) deserializeSchedule(blob.data(), blob.size(), copy);
+    auto t2 = std::chrono::steady_clock::now();
+    bool same = copy.size() == plan.size();
+    for (size_t i = 0; same && i < plan.size(); ++i) {
+        same = copy[i].proc == plan[i].proc && copy[i].startTime == plan[i].startTime &&
+               copy[i].endTime == plan[i].endTime && copy[i].op == plan[i].op && copy[i].task == plan[i].task;
+    }
+    size_t total = blob.size() * repeat;
+    std::cout << "Schedule: " << plan.size() << " assignments, " << std::fixed << std::setprecision(2)
+              << (double)blob.size() / plan.size() << " B/assignment (in memory "
+              << sizeof(TaskAssignment) << "), encode "
+              << gbPerSecond(total, std::chrono::duration<double>(t1 - t0).count()) << " GB/s, decode "
+              << gbPerSecond(total, std::chrono::duration<double>(t2 - t1).count()) << " GB/s, round trip "
+              << (same ? "ok" : "MISMATCH") << std::defaultfloat << std::setprecision(6) << std::endl;
+}
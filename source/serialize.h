@@ -0,0 +1,100 @@
+#pragma once
+
+#include "parser.h"
+#include "modeling.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Двійкові формати дерева і плану. Заголовок — 4 байти: два байти типу ("CT" — дерево,
+// "CS" — план), версія, зарезервований байт. Далі таблиця рядків (імена змінних або операцій,
+// кожен рядок один раз) і записи. Цілі — varint (LEB128), знакові — через zigzag.
+const uint8_t kTreeFormatVersion = 1;
+const uint8_t kScheduleFormatVersion = 1;
+
+std::string serializeTree(const prsr::Node* root);
+bool deserializeTree(const char* data, size_t size, prsr::Node*& root);
+std::string serializeSchedule(const std::vector<TaskAssignment>& assignments);
+bool deserializeSchedule(const char* data, size_t size, std::vector<TaskAssignment>& assignments);
+
+// Вузол, прочитаний із буфера без копіювання: value вказує всередину буфера або таблиці рядків
+struct TreeNodeRef {
+    bool isNull = false;
+    bool isOperator = false;
+    bool isNumber = false;
+    bool isVariable = false;
+    uint32_t children = 0;
+    std::string_view value;   // для чисел, закодованих як число, порожнє — див. number
+    double number = 0.0;
+};
+
+// Перегляд дерева поверх чужого буфера (напр. відображеного файлу) у прямому порядку.
+// Буфер має жити довше за перегляд; open перевіряє заголовок і таблицю рядків.
+class TreeView {
+public:
+    bool open(const char* data, size_t size);
+    size_t nodeCount() const { return count; }
+
+    class Cursor {
+    public:
+        bool next(TreeNodeRef& node);   // false — кінець або пошкоджені дані
+        bool failed() const { return bad; }
+
+    private:
+        friend class TreeView;
+        const TreeView* view = nullptr;
+        size_t pos = 0;
+        size_t left = 0;
+        bool bad = false;
+    };
+
+    Cursor begin() const;
+    bool materialize(prsr::Node*& root) const;
+
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+    size_t body = 0;
+    size_t count = 0;
+    std::vector<std::string_view> strings;
+};
+
+struct TaskAssignmentRef {
+    int proc;
+    int startTime;
+    int endTime;
+    int task;
+    std::string_view op;
+};
+
+class ScheduleView {
+public:
+    bool open(const char* data, size_t size);
+    size_t size() const { return count; }
+
+    class Cursor {
+    public:
+        bool next(TaskAssignmentRef& assignment);
+        bool failed() const { return bad; }
+
+    private:
+        friend class ScheduleView;
+        const ScheduleView* view = nullptr;
+        size_t pos = 0;
+        size_t left = 0;
+        long long start = 0;
+        long long task = -1;
+        bool bad = false;
+    };
+
+    Cursor begin() const;
+
+private:
+    const char* data = nullptr;
+    size_t bytes = 0;
+    size_t body = 0;
+    size_t count = 0;
+    std::vector<std::string_view> strings;
+};
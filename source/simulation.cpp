@@ -0,0 +1,512 @@
+#include "parser.h"
+#include "modeling.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <numeric>
+#include <cstdint>
+#include <bit>
+
+namespace {
+
+// Порядок подій у купі: менший час раніше, при рівності — порядок вставки
+struct EventLater {
+    bool operator()(const SimEvent& a, const SimEvent& b) const {
+        if (a.time != b.time) return a.time > b.time;
+        return a.seq > b.seq;
+    }
+};
+
+// Множина готових задач за рангом пріоритету: ієрархія бітових масок по 64 біти.
+// Вставка і вибір найменшого рангу — кілька слів на рівень замість просіювання купи.
+class RankSet {
+public:
+    void reset(size_t size) {
+        levels.clear();
+        count = 0;
+        do {
+            size = (size + 63) / 64;
+            levels.emplace_back(size, 0);
+        } while (size > 1);
+    }
+
+    bool empty() const { return count == 0; }
+
+    void insert(int rank) {
+        size_t bit = (size_t)rank;
+        for (auto& level : levels) {
+            uint64_t& word = level[bit / 64];
+            bool wasEmpty = word == 0;
+            word |= 1ull << (bit % 64);
+            if (!wasEmpty) break;
+            bit /= 64;
+        }
+        ++count;
+    }
+
+    int popMin() {
+        size_t index = 0;
+        for (size_t l = levels.size(); l-- > 0;) index = index * 64 + std::countr_zero(levels[l][index]);
+        size_t bit = index;
+        for (auto& level : levels) {
+            uint64_t& word = level[bit / 64];
+            word &= word - 1;  // найменший біт слова — саме той, що знайдено
+            if (word != 0) break;
+            bit /= 64;
+        }
+        --count;
+        return (int)index;
+    }
+
+private:
+    std::vector<std::vector<uint64_t>> levels;  // levels[0] — по біту на ранг
+    size_t count = 0;
+};
+
+// Ядро симулятора: процесори, завершення операцій і доставка даних — події в черзі з пріоритетом
+class Simulator {
+public:
+    // Суміжність читається прямо з CSR-масивів графа
+    Simulator(const TaskGraph& graph, const MachineModel& machine, bool keepTrace)
+        : graph(graph), machine(machine), keepTrace(keepTrace), remainingPreds(graph.inDegree),
+          predStart(graph.predStart), predList(graph.predList), succStart(graph.succStart), succList(graph.succList) {
+        size_t n = graph.size();
+        pendingInputs.assign(n, 0);
+        taskProc.assign(n, -1);
+        startTime.assign(n, 0.0);
+        finishTime.assign(n, 0.0);
+        work.assign(graph.duration.begin(), graph.duration.end());
+        invSpeed.resize(machine.procCount);
+        for (int p = 0; p < machine.procCount; ++p) {
+            invSpeed[p] = 1.0 / machine.procSpeed(p);
+            if (invSpeed[p] != invSpeed[0]) uniform = false;
+        }
+        if (machine.hasOverrides()) {
+            uniform = false;
+            durTable.resize(n * machine.procCount);
+            for (size_t i = 0; i < n; ++i) {
+                for (int p = 0; p < machine.procCount; ++p) {
+                    durTable[i * machine.procCount + p] = machine.opDuration(graph.op((int)i), p);
+                }
+            }
+        }
+        procBusy.assign(machine.procCount, 0);
+        busyTime.assign(machine.procCount, 0.0);
+        heap.reserve(64);
+        if (keepTrace) trace.reserve(n);
+    }
+
+    // Режим відтворення: кожен процесор виконує свої задачі у запланованому порядку
+    void setPlan(const std::vector<TaskAssignment>& plan) {
+        replay = true;
+        plannedProc.assign(graph.size(), -1);
+        // Сортуються індекси плану, а не самі призначення з рядками операцій
+        std::vector<int> order;
+        order.reserve(plan.size());
+        for (int i = 0; i < (int)plan.size(); ++i) {
+            const TaskAssignment& t = plan[i];
+            if (t.task < 0 || t.task >= (int)graph.size()) continue;
+            if (t.proc < 0 || t.proc >= machine.procCount) continue;
+            order.push_back(i);
+        }
+        if (!std::is_sorted(order.begin(), order.end(), [&](int a, int b) { return plan[a].startTime < plan[b].startTime; })) {
+            std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return plan[a].startTime < plan[b].startTime; });
+        }
+        // Черги процесорів у форматі CSR: procHead[p] — наступна задача, procStart[p + 1] — кінець черги
+        procStart.assign(machine.procCount + 1, 0);
+        for (int i : order) procStart[plan[i].proc + 1]++;
+        for (int p = 0; p < machine.procCount; ++p) procStart[p + 1] += procStart[p];
+        procHead.assign(procStart.begin(), procStart.end() - 1);
+        procQueue.resize(order.size());
+        std::vector<int> fill = procHead;
+        for (int i : order) {
+            procQueue[fill[plan[i].proc]++] = plan[i].task;
+            plannedProc[plan[i].task] = plan[i].proc;
+        }
+    }
+
+    // Режим політики: готові задачі роздаються вільним процесорам за пріоритетом
+    void setPriority(const SimPriority& priority) {
+        replay = false;
+        // Пріоритет задачі сталий, тож задачі впорядковуються один раз: більший пріоритет
+        // раніше, при рівності — менший індекс
+        size_t n = graph.size();
+        std::vector<std::pair<double, int>> keyed(n);
+        for (size_t i = 0; i < n; ++i) keyed[i] = {priority ? -priority((int)i) : 0.0, (int)i};
+        std::sort(keyed.begin(), keyed.end());
+        byRank.resize(n);
+        rank.resize(n);
+        for (size_t r = 0; r < n; ++r) {
+            byRank[r] = keyed[r].second;
+            rank[keyed[r].second] = (int)r;
+        }
+        ready.reset(n);
+        idle.clear();
+        idlePos.assign(machine.procCount, -1);
+        for (int p = machine.procCount - 1; p >= 0; --p) addIdle(p);
+    }
+
+    SimResult run() {
+        if (replay) {
+            for (size_t i = 0; i < graph.size(); ++i) {
+                if (remainingPreds[i] == 0) onReady((int)i);
+            }
+        } else {
+            for (size_t i = 0; i < graph.size(); ++i) {
+                if (remainingPreds[i] == 0) ready.insert(rank[i]);
+            }
+            dispatchReady();
+        }
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), EventLater());
+            SimEvent e = heap.back();
+            heap.pop_back();
+            now = e.time;
+            ++events;
+            if (e.type == SimEventType::TaskFinish) onFinish(e.task, e.proc);
+            else onArrival(e.task, e.proc);
+        }
+        return collect();
+    }
+
+private:
+    const TaskGraph& graph;
+    const MachineModel& machine;
+    bool keepTrace;
+    bool replay = false;
+    bool uniform = true;
+    double now = 0.0;
+    unsigned long long seq = 0;
+    unsigned long long events = 0;
+
+    std::vector<SimEvent> heap;
+    std::vector<int> remainingPreds;
+    const std::vector<int>& predStart;
+    const std::vector<int>& predList;
+    const std::vector<int>& succStart;
+    const std::vector<int>& succList;
+    std::vector<int> pendingInputs;
+    std::vector<int> taskProc;
+    std::vector<double> work;      // тривалість на базовій швидкості
+    std::vector<double> invSpeed;
+    std::vector<double> durTable;  // задача x процесор, лише якщо є перевизначення
+    std::vector<double> startTime;
+    std::vector<double> finishTime;
+    std::vector<char> procBusy;
+    std::vector<double> busyTime;
+    std::vector<SimTraceEntry> trace;
+
+    // replay
+    std::vector<int> procQueue;
+    std::vector<int> procStart;
+    std::vector<int> procHead;
+    std::vector<int> plannedProc;
+    // policy
+    std::vector<int> rank;
+    std::vector<int> byRank;
+    RankSet ready;
+    std::vector<int> idle;
+    std::vector<int> idlePos;
+
+    void push(double time, SimEventType type, int task, int proc) {
+        heap.push_back({time, seq++, task, proc, type});
+        std::push_heap(heap.begin(), heap.end(), EventLater());
+    }
+
+    // Задача зайняла процесор; віддалені входи надходять окремими подіями
+    void dispatch(int task, int proc) {
+        procBusy[proc] = 1;
+        taskProc[task] = proc;
+        int remote = 0;
+        if (machine.commLatency > 0.0) {
+            for (int k = predStart[task]; k < predStart[task + 1]; ++k) {
+                int p = predList[k];
+                if (taskProc[p] == proc) continue;
+                double arrival = finishTime[p] + machine.commLatency;
+                if (arrival <= now) continue;
+                push(arrival, SimEventType::DataArrival, task, proc);
+                ++remote;
+            }
+        }
+        pendingInputs[task] = remote;
+        if (remote == 0) start(task, proc);
+    }
+
+    void start(int task, int proc) {
+        startTime[task] = now;
+        push(now + duration(task, proc), SimEventType::TaskFinish, task, proc);
+    }
+
+    void onArrival(int task, int proc) {
+        if (--pendingInputs[task] == 0) start(task, proc);
+    }
+
+    void onFinish(int task, int proc) {
+        finishTime[task] = now;
+        procBusy[proc] = 0;
+        busyTime[proc] += now - startTime[task];
+        if (keepTrace) trace.push_back({task, proc, startTime[task], now});
+        if (!replay) addIdle(proc);
+        for (int k = succStart[task]; k < succStart[task + 1]; ++k) {
+            int s = succList[k];
+            if (--remainingPreds[s] == 0) onReady(s);
+        }
+        if (replay) tryProc(proc);
+        else dispatchReady();
+    }
+
+    void onReady(int task) {
+        if (replay) {
+            if (plannedProc[task] >= 0) tryProc(plannedProc[task]);
+        } else {
+            ready.insert(rank[task]);
+        }
+    }
+
+    void tryProc(int proc) {
+        if (procBusy[proc] || procHead[proc] >= procStart[proc + 1]) return;
+        int task = procQueue[procHead[proc]];
+        if (remainingPreds[task] != 0) return;
+        ++procHead[proc];
+        dispatch(task, proc);
+    }
+
+    void addIdle(int proc) {
+        idlePos[proc] = (int)idle.size();
+        idle.push_back(proc);
+    }
+
+    void takeIdle(int proc) {
+        int pos = idlePos[proc];
+        idle[pos] = idle.back();
+        idlePos[idle[pos]] = pos;
+        idle.pop_back();
+        idlePos[proc] = -1;
+    }
+
+    double finishOn(int task, int proc) const {
+        double ready = now;
+        for (int k = predStart[task]; k < predStart[task + 1]; ++k) {
+            int pr = predList[k];
+            if (taskProc[pr] != proc) ready = std::max(ready, finishTime[pr] + machine.commLatency);
+        }
+        return ready + duration(task, proc);
+    }
+
+    double duration(int task, int proc) const {
+        if (!durTable.empty()) return durTable[(size_t)task * machine.procCount + proc];
+        return work[task] * invSpeed[proc];
+    }
+
+    // Найкращий вільний процесор — той, на якому задача завершиться найраніше.
+    // Кандидати: процесори, де вже лежать входи задачі, і найшвидший вільний.
+    void dispatchReady() {
+        while (!ready.empty() && !idle.empty()) {
+            int task = byRank[ready.popMin()];
+            int best = idle.back();
+            double bestFinish = finishOn(task, best);
+            if (!uniform) {
+                for (int p : idle) {
+                    double finish = finishOn(task, p);
+                    if (finish < bestFinish) {
+                        bestFinish = finish;
+                        best = p;
+                    }
+                }
+            }
+            for (int k = predStart[task]; k < predStart[task + 1]; ++k) {
+                int p = taskProc[predList[k]];
+                if (p < 0 || idlePos[p] < 0 || p == best) continue;
+                double finish = finishOn(task, p);
+                if (finish < bestFinish) {
+                    bestFinish = finish;
+                    best = p;
+                }
+            }
+            takeIdle(best);
+            dispatch(task, best);
+        }
+    }
+
+    SimResult collect() {
+        SimResult result;
+        result.trace = std::move(trace);
+        result.procBusy = busyTime;
+        result.events = events;
+        for (size_t i = 0; i < graph.size(); ++i) {
+            result.makespan = std::max(result.makespan, finishTime[i]);
+        }
+        result.seqTime = fastestSingleProcTime(graph, machine);
+        for (double b : busyTime) {
+            if (b > 0.0) result.usedProcs++;
+        }
+        return result;
+    }
+};
+
+} // namespace
+
+// Послідовний час на найшвидшому одиночному процесорі — база для прискорення
+double fastestSingleProcTime(const TaskGraph& graph, const MachineModel& machine) {
+    if (!machine.hasOverrides()) {
+        double work = 0.0, maxSpeed = 0.0;
+        for (int d : graph.duration) work += d;
+        for (int p = 0; p < machine.procCount; ++p) maxSpeed = std::max(maxSpeed, machine.procSpeed(p));
+        return maxSpeed > 0.0 ? work / maxSpeed : work;
+    }
+    double best = 0.0;
+    for (int p = 0; p < machine.procCount; ++p) {
+        double total = 0.0;
+        for (int i = 0; i < (int)graph.size(); ++i) total += machine.opDuration(graph.op(i), p);
+        if (p == 0 || total < best) best = total;
+    }
+    return best;
+}
+
+// План для відтворення: порядок на кожному процесорі береться з трасування
+std::vector<TaskAssignment> traceToPlan(const TaskGraph& graph, const std::vector<SimTraceEntry>& trace) {
+    std::vector<SimTraceEntry> sorted = trace;
+    std::sort(sorted.begin(), sorted.end(), [](const SimTraceEntry& a, const SimTraceEntry& b) {
+        return a.start < b.start;
+    });
+    std::vector<TaskAssignment> plan;
+    for (const auto& t : sorted) {
+        plan.push_back({t.proc, (int)std::floor(t.start), (int)std::ceil(t.end), graph.op(t.task), t.task});
+    }
+    return plan;
+}
+
+// Нижній рівень задачі: найдовший шлях від неї до кінця графа (на базовій швидкості)
+std::vector<double> bottomLevels(const TaskGraph& graph, const MachineModel& machine) {
+    std::vector<double> level(graph.size(), 0.0);
+    // Пост-порядок: наступники мають більші індекси, тож ідемо з кінця
+    for (int i = (int)graph.size() - 1; i >= 0; --i) {
+        double tail = 0.0;
+        for (int s : graph.succs(i)) tail = std::max(tail, level[s] + machine.commLatency);
+        level[i] = graph.duration[i] + tail;
+    }
+    return level;
+}
+
+SimResult simulateSchedule(const TaskGraph& graph, const MachineModel& machine,
+                           const std::vector<TaskAssignment>& plan, bool keepTrace) {
+    Simulator sim(graph, machine, keepTrace);
+    sim.setPlan(plan);
+    return sim.run();
+}
+
+SimResult simulatePolicy(const TaskGraph& graph, const MachineModel& machine,
+                         const SimPriority& priority, bool keepTrace) {
+    Simulator sim(graph, machine, keepTrace);
+    sim.setPriority(priority);
+    return sim.run();
+}
+
+void printSimResult(const TaskGraph& graph, const SimResult& result, int procCount) {
+    computeMetrics(result.seqTime, result.makespan, result.usedProcs, procCount);
+    if (result.events > 0) std::cout << "Events processed: " << result.events << std::endl;
+    std::vector<SimTraceEntry> trace = result.trace;
+    std::sort(trace.begin(), trace.end(), [](const SimTraceEntry& a, const SimTraceEntry& b) {
+        return a.proc != b.proc ? a.proc < b.proc : a.start < b.start;
+    });
+    std::cout << std::fixed << std::setprecision(2);
+    for (int p = 0; p < procCount; ++p) {
+        std::cout << "P" << p + 1 << ": ";
+        for (const auto& t : trace) {
+            if (t.proc != p) continue;
+            std::cout << "[" << graph.op(t.task) << " " << t.start << "-" << t.end << "]";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+}
+
+namespace {
+
+// Синтетичний граф: збалансоване дерево з leafCount листками і випадковими операціями
+TaskGraph balancedTaskGraph(int leafCount, std::mt19937& rng) {
+    TaskGraphBuilder builder;
+    const char* ops[] = { "+", "-", "*", "/" };
+    std::vector<int> level;
+    for (int i = 0; i + 1 < leafCount; i += 2) level.push_back(builder.addTask(ops[rng() % 4], {}));
+    while (level.size() > 1) {
+        std::vector<int> next;
+        for (size_t i = 0; i < level.size(); i += 2) {
+            if (i + 1 >= level.size()) {
+                next.push_back(level[i]);
+                continue;
+            }
+            next.push_back(builder.addTask(ops[rng() % 4], {level[i], level[i + 1]}));
+        }
+        level = next;
+    }
+    return builder.build();
+}
+
+} // namespace
+
+// Підготовка (ранги пріоритетів, черги плану) і цикл подій міряються окремо:
+// підготовка — O(n log n) сортування, сам цикл — події за секунду
+void prsr::benchmarkSimulator() {
+    const int procCount = 8;
+    std::mt19937 rng(42);
+    MachineModel machine = makeUniformMachine(procCount);
+    machine.commLatency = 0.5;
+    std::cout << "\n=== Discrete-event simulator, " << procCount << " processors, comm latency "
+              << machine.commLatency << " ===" << std::endl;
+    std::cout << "   Tasks | mode   |   events | setup, ms | loop, ms | loop events/s | total events/s" << std::endl;
+    for (int leaves : {1 << 12, 1 << 16, 1 << 21}) {
+        TaskGraph graph = balancedTaskGraph(leaves, rng);
+        std::vector<double> bl = bottomLevels(graph, machine);
+        std::vector<TaskAssignment> plan = scheduleTaskGraph(graph, procCount);
+        for (bool policy : {true, false}) {
+            auto t0 = std::chrono::steady_clock::now();
+            Simulator sim(graph, machine, false);
+            if (policy) sim.setPriority([&](int task) { return bl[task]; });
+            else sim.setPlan(plan);
+            auto t1 = std::chrono::steady_clock::now();
+            SimResult result = sim.run();
+            auto t2 = std::chrono::steady_clock::now();
+            double setup = std::chrono::duration<double>(t1 - t0).count();
+            double loop = std::chrono::duration<double>(t2 - t1).count();
+            std::cout << std::setw(8) << graph.size() << " | " << (policy ? "policy" : "replay") << " | "
+                      << std::setw(8) << result.events << " | " << std::fixed << std::setprecision(1)
+                      << std::setw(9) << setup * 1e3 << " | " << std::setw(8) << loop * 1e3 << " | "
+                      << std::scientific << std::setprecision(2) << std::setw(13)
+                      << (loop > 0 ? result.events / loop : 0.0) << " | " << std::setw(14)
+                      << (setup + loop > 0 ? result.events / (setup + loop) : 0.0)
+                      << std::defaultfloat << std::setprecision(6) << std::endl;
+        }
+    }
+}
+
+// === Прогін статичного розкладу і динамічної політики на моделі машини ===
+void prsr::simulateSystem(const std::string& expr, int procCount) {
+    if (!validateExpression(expr)) {
+        std::cout << "Error: the expression is not valid!" << std::endl;
+        return;
+    }
+    prsr::Node* tree = buildOptimizedTree(expr);
+    tree = prsr::optimizeParallelTree(tree);
+    if (!tree) {
+        std::cout << "Error: failed to build the tree!" << std::endl;
+        return;
+    }
+    TaskGraph graph = flattenTaskGraph(tree);
+    MachineModel machine = makeUniformMachine(procCount);
+
+    std::cout << "\n=== Simulation: replay of the static schedule on " << procCount << " processors ===" << std::endl;
+    auto plan = assignTasksWithDependencies(tree, procCount);
+    printSimResult(graph, simulateSchedule(graph, machine, plan), procCount);
+
+    std::cout << "\n=== Simulation: critical-path list scheduling on " << procCount << " processors ===" << std::endl;
+    std::vector<double> bl = bottomLevels(graph, machine);
+    printSimResult(graph, simulatePolicy(graph, machine, [&](int task) { return bl[task]; }), procCount);
+
+    delete tree;
+}
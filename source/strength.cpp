@@ -0,0 +1,206 @@
+#include "parser.h"
+#include "modeling.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <map>
+#include <cmath>
+#include <algorithm>
+
+using namespace prsr;
+
+namespace {
+
+// Зважена робота піддерева за таблицею getOpDuration
+int subtreeWork(const Node* node) {
+    if (!node || !node->isOperator) return 0;
+    int work = getOpDuration(node->value);
+    for (const Node* child : node->children) work += subtreeWork(child);
+    return work;
+}
+
+bool isBinary(const Node* node, const std::string& op) {
+    return node && node->isOperator && node->value == op && node->children.size() == 2 &&
+           node->children[0] && node->children[1];
+}
+
+// Обернене число, яке formatNumber записує точно (X/4 -> X*0.25, але не X/3)
+bool exactReciprocal(const Node* number, std::string& text) {
+    if (!number || !number->isNumber) return false;
+    double value = std::stod(number->value);
+    if (value == 0.0) return false;
+    text = formatNumber(1.0 / value);
+    return std::stod(text) * value == 1.0;
+}
+
+Node* joinTerms(const std::vector<Node*>& pos, const std::vector<Node*>& neg) {
+    Node* acc = pos[0];
+    for (size_t i = 1; i < pos.size(); ++i) {
+        Node* next = new Node("+", true, false, false);
+        next->children = {acc, pos[i]};
+        acc = next;
+    }
+    for (Node* term : neg) {
+        Node* next = new Node("-", true, false, false);
+        next->children = {acc, term};
+        acc = next;
+    }
+    return acc;
+}
+
+// Спільний знаменник у групі +/-: A/D+B/D-C/D -> (A+B-C)/D. Доданки переходять у власність
+// результату; merged — скільки ділень зекономлено.
+Node* shareDenominators(std::vector<Node*> pos, std::vector<Node*> neg, int& merged) {
+    std::map<std::string, std::vector<std::pair<Node*, bool>>> byDenominator;
+    std::vector<std::string> order;
+    auto classify = [&](Node* term, bool negative) {
+        if (!isBinary(term, "/")) return;
+        std::string key = treeToString(term->children[1]);
+        auto& members = byDenominator[key];
+        if (members.empty()) order.push_back(key);
+        members.push_back({term, negative});
+    };
+    for (Node* t : pos) classify(t, false);
+    for (Node* t : neg) classify(t, true);
+    auto erase = [](std::vector<Node*>& terms, Node* t) { terms.erase(std::find(terms.begin(), terms.end(), t)); };
+    for (const auto& key : order) {
+        auto& members = byDenominator[key];
+        if (members.size() < 2) continue;
+        std::vector<Node*> numPos, numNeg;
+        Node* denominator = members[0].first->children[1];
+        for (auto& [term, negative] : members) {
+            (negative ? numNeg : numPos).push_back(term->children[0]);
+            erase(negative ? neg : pos, term);
+            if (term->children[1] != denominator) delete term->children[1];
+            term->children.clear();
+            delete term;
+        }
+        merged += (int)members.size() - 1;
+        bool negative = numPos.empty();
+        Node* division = new Node("/", true, false, false);
+        division->children = {negative ? joinTerms(numNeg, {}) : joinTerms(numPos, numNeg), denominator};
+        (negative ? neg : pos).push_back(division);
+    }
+    // Лівий доданок групи завжди додатний, тож pos не порожній
+    return joinTerms(pos, neg);
+}
+
+Node* reduce(Node* node, StrengthReport& report);
+
+bool isSumGroup(const Node* node) {
+    return node && node->isOperator && (node->value == "+" || node->value == "-");
+}
+
+// Доданки групи +/- обробляються на місці, форма групи зберігається
+void reduceGroupTerms(Node* group, StrengthReport& report) {
+    for (auto& child : group->children) {
+        if (isSumGroup(child)) reduceGroupTerms(child, report);
+        else child = reduce(child, report);
+    }
+}
+
+Node* reduce(Node* node, StrengthReport& report) {
+    if (!node || !node->isOperator) return node;
+    if (isSumGroup(node)) {
+        reduceGroupTerms(node, report);
+        // Вигода перевіряється на копії: злиття ділень може подовжити критичний шлях
+        Node* copy = cloneSubtree(node);
+        std::vector<Node*> pos, neg, inner;
+        bool hasNull = false;
+        collectSigned(copy, "+", "-", true, pos, neg, inner, hasNull);
+        if (hasNull) {
+            delete copy;
+            return node;
+        }
+        for (Node* n : inner) {
+            n->children.clear();
+            delete n;
+        }
+        int merged = 0;
+        Node* candidate = shareDenominators(pos, neg, merged);
+        int work = subtreeWork(node), path = criticalPathLength(node);
+        int newWork = subtreeWork(candidate), newPath = criticalPathLength(candidate);
+        if (merged > 0 && ((newWork < work && newPath <= path) || (newPath < path && newWork <= work))) {
+            report.sharedDivisions += merged;
+            delete node;
+            return candidate;
+        }
+        delete candidate;
+        return node;
+    }
+    for (auto& child : node->children) child = reduce(child, report);
+    std::string reciprocal;
+    // X / c -> X * (1/c): множення дешевше за ділення
+    if (isBinary(node, "/") && exactReciprocal(node->children[1], reciprocal) &&
+        getOpDuration("*") < getOpDuration("/")) {
+        node->value = "*";
+        node->children[1]->value = reciprocal;
+        ++report.reciprocals;
+        return node;
+    }
+    // X * 2 -> X + X лише для листка X: піддерево довелося б обчислювати двічі
+    if (isBinary(node, "*") && getOpDuration("+") < getOpDuration("*")) {
+        for (int i = 0; i < 2; ++i) {
+            Node* two = node->children[i];
+            Node* other = node->children[1 - i];
+            if (two->isNumber && std::stod(two->value) == 2.0 && !other->isOperator) {
+                node->value = "+";
+                delete two;
+                node->children = {other, cloneSubtree(other)};
+                ++report.doublings;
+                return node;
+            }
+        }
+    }
+    return node;
+}
+
+} // namespace
+
+namespace prsr {
+
+// Зниження вартості операцій за таблицею getOpDuration: ділення на сталу — множенням
+// на обернене, множення на 2 — додаванням, спільний знаменник — одним діленням.
+// Переписування застосовується, лише якщо не погіршує ні роботу, ні критичний шлях.
+Node* reduceStrength(Node* root, StrengthReport* report) {
+    StrengthReport local;
+    return reduce(root, report ? *report : local);
+}
+
+// === Звіт: робота і критичний шлях до і після зниження вартості ===
+void modelStrengthReduction(const std::string& expr, int procCount) {
+    if (!validateExpression(expr)) {
+        std::cout << "Error: the expression is not valid!" << std::endl;
+        return;
+    }
+    Node* before = prsr::buildParseTree(prsr::simplifyExpression(expr));
+    if (!before) {
+        std::cout << "Error: failed to build the tree!" << std::endl;
+        return;
+    }
+    StrengthReport report;
+    Node* after = reduceStrength(cloneSubtree(before), &report);
+    std::cout << "\n=== Strength reduction, " << procCount << " processors ===" << std::endl;
+    std::cout << "Before: " << treeToString(before) << std::endl;
+    std::cout << "After:  " << treeToString(after) << std::endl;
+    std::cout << "Rewrites: " << report.reciprocals << " division(s) by a constant, "
+              << report.doublings << " doubling(s), " << report.sharedDivisions
+              << " division(s) merged by a common denominator" << std::endl;
+    std::cout << "       | work | critical path | makespan" << std::endl;
+    auto row = [&](const char* name, Node* tree) {
+        Node* scheduled = optimizeParallelTree(cloneSubtree(tree));
+        int makespan = 0;
+        for (const auto& t : assignTasksWithDependencies(scheduled, procCount)) makespan = std::max(makespan, t.endTime);
+        std::cout << std::setw(6) << name << " | " << std::setw(4) << subtreeWork(tree)
+                  << " | " << std::setw(13) << criticalPathLength(scheduled)
+                  << " | " << std::setw(8) << makespan << std::endl;
+        delete scheduled;
+    };
+    row("before", before);
+    row("after", after);
+    delete before;
+    delete after;
+}
+
+} // namespace prsr
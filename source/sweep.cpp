@@ -0,0 +1,251 @@
+#include "parser.h"
+#include "modeling.h"
+#include "cache.h"
+#include "runtime.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <random>
+#include <climits>
+#include <stdexcept>
+#include <algorithm>
+
+SweepAnalysis analyzeForSweep(prsr::Node* tree) {
+    SweepAnalysis analysis;
+    analysis.graph = flattenTaskGraph(tree);
+    analysis.levels = (int)groupByLevels(tree).size();
+    const TaskGraph& graph = analysis.graph;
+    std::vector<int> finish(graph.size(), 0);
+    for (int i = 0; i < (int)graph.size(); ++i) {
+        int start = graph.release[i];
+        for (int p : graph.preds(i)) start = std::max(start, finish[p]);
+        finish[i] = start + graph.duration[i];
+        analysis.totalWork += graph.duration[i];
+        analysis.criticalPath = std::max(analysis.criticalPath, finish[i]);
+    }
+    return analysis;
+}
+
+// "1..1024", "1,2,5,6,8,10" або суміш: "1..8, 16, 32, 64"
+bool parseProcessorRange(const std::string& text, std::vector<int>& procCounts) {
+    const int maxProcs = 65536;
+    procCounts.clear();
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
+        if (item.empty()) continue;
+        size_t dots = item.find("..");
+        int first = 0, last = 0;
+        size_t used = 0;
+        try {
+            if (dots == std::string::npos) {
+                first = last = std::stoi(item, &used);
+                if (used != item.size()) throw std::invalid_argument(item);
+            } else {
+                std::string to = item.substr(dots + 2);
+                first = std::stoi(item.substr(0, dots), &used);
+                if (used != dots) throw std::invalid_argument(item);
+                last = std::stoi(to, &used);
+                if (used != to.size()) throw std::invalid_argument(item);
+            }
+        } catch (const std::exception&) {
+            std::cout << "Error: cannot parse processor count '" << item << "'" << std::endl;
+            return false;
+        }
+        if (first < 1 || last > maxProcs || first > last) {
+            std::cout << "Error: processor range '" << item << "' must lie within 1.." << maxProcs << std::endl;
+            return false;
+        }
+        for (int p = first; p <= last; ++p) procCounts.push_back(p);
+    }
+    std::sort(procCounts.begin(), procCounts.end());
+    procCounts.erase(std::unique(procCounts.begin(), procCounts.end()), procCounts.end());
+    return !procCounts.empty();
+}
+
+// Кожне P — окрема задача пулу; P беруться за зростанням. Якщо якийсь процесор залишився
+// вільним (usedProcs < P), кожна задача стартувала при готовності входів на процесорі
+// з найменшим номером, і для всіх більших P план буде тим самим до останнього призначення.
+// Рівність makespan критичному шляху зупинкою не є: scheduleTaskGraph при рівних часах
+// бере процесор з меншим номером, і при P+1 makespan може знову стати довшим.
+SweepResult sweepProcessors(const SweepAnalysis& analysis, std::vector<int> procCounts, int threads,
+                            bool keepAssignments) {
+    std::sort(procCounts.begin(), procCounts.end());
+    procCounts.erase(std::unique(procCounts.begin(), procCounts.end()), procCounts.end());
+    SweepResult result;
+    result.points.resize(procCounts.size());
+    if (procCounts.empty()) return result;
+
+    std::atomic<int> stopAt{INT_MAX};
+    std::function<void(int)> body = [&](int i) {
+        int p = procCounts[i];
+        if (p > stopAt.load(std::memory_order_acquire)) return;
+        SweepPoint& point = result.points[i];
+        point.procCount = p;
+        point.computed = true;
+        std::vector<char> used(p, 0);
+        point.assignments = scheduleTaskGraph(analysis.graph, p);
+        for (const auto& t : point.assignments) {
+            point.makespan = std::max(point.makespan, t.endTime);
+            if (!used[t.proc]) {
+                used[t.proc] = 1;
+                point.usedProcs++;
+            }
+        }
+        if (!keepAssignments) point.assignments = std::vector<TaskAssignment>();
+        if (point.usedProcs == p) return;
+        int current = stopAt.load(std::memory_order_acquire);
+        while (p < current && !stopAt.compare_exchange_weak(current, p, std::memory_order_acq_rel)) {}
+    };
+    RuntimeGraph tasks;
+    tasks.inDegree.assign(procCounts.size(), 0);
+    tasks.succStart.assign(procCounts.size() + 1, 0);
+    // Пакет з однієї задачі: інакше потік захопить кілька P поспіль і пропустить зупинку
+    TaskRuntime runtime(std::max(1, std::min(threads, (int)procCounts.size())), 1);
+    runtime.run(tasks, body);
+
+    int stop = stopAt.load();
+    size_t source = std::lower_bound(procCounts.begin(), procCounts.end(), stop) - procCounts.begin();
+    for (size_t i = 0; i < result.points.size(); ++i) {
+        SweepPoint& point = result.points[i];
+        if (point.computed) {
+            result.computed++;
+        } else {
+            point = result.points[source];
+            point.procCount = procCounts[i];
+            point.computed = false;
+        }
+    }
+    if (stop != INT_MAX) result.saturatedAt = stop;
+    return result;
+}
+
+// === Розгортка за кількістю процесорів: один аналіз дерева, плани для всіх P паралельно ===
+void prsr::sweepProcessorCounts(const std::string& expr, const std::string& rangeText) {
+    std::vector<int> procCounts;
+    if (!parseProcessorRange(rangeText, procCounts)) {
+        std::cout << "Error: the processor range is empty or not valid!" << std::endl;
+        return;
+    }
+    auto parsed = analyzeExpression(expr, {});
+    if (!parsed->valid) {
+        std::cout << "Error: the expression is not valid!" << std::endl;
+        return;
+    }
+    int threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    auto t0 = std::chrono::steady_clock::now();
+    SweepAnalysis analysis = analyzeForSweep(parsed->root());
+    SweepResult sweep = sweepProcessors(analysis, procCounts, threads, false);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::cout << "\n=== Processor sweep: " << parsed->corrected << " over " << procCounts.size()
+              << " processor counts ===" << std::endl;
+    std::cout << "Operations: " << analysis.graph.size() << ", total work: " << analysis.totalWork
+              << ", critical path: " << analysis.criticalPath << ", levels: " << analysis.levels << std::endl;
+    std::cout << "Procs | makespan | used | speedup | efficiency" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& point : sweep.points) {
+        if (!point.computed) break;
+        double speedup = point.makespan > 0 ? (double)analysis.totalWork / point.makespan : 0.0;
+        std::cout << std::setw(5) << point.procCount << " | " << std::setw(8) << point.makespan << " | "
+                  << std::setw(4) << point.usedProcs << " | " << std::setw(7) << speedup << " | "
+                  << std::setw(10) << speedup / point.procCount << std::endl;
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+    if (sweep.saturatedAt) {
+        std::cout << "Processors stay idle from P=" << sweep.saturatedAt
+                  << "; more processors do not change the plan" << std::endl;
+    } else {
+        std::cout << "Every processor is still busy at P=" << procCounts.back() << std::endl;
+    }
+    std::cout << "Scheduled " << sweep.computed << " of " << procCounts.size() << " processor counts on "
+              << threads << " threads in " << std::fixed << std::setprecision(2) << seconds * 1e3 << " ms"
+              << std::defaultfloat << std::setprecision(6) << std::endl;
+}
+
+namespace {
+
+// Випадкове дерево: пари піддерев зливаються у випадковому порядку, тож глибина нерівна
+prsr::Node* randomTree(int leafCount, std::mt19937& rng) {
+    const char* ops[] = {"+", "-", "*", "/"};
+    std::vector<prsr::Node*> pool;
+    for (int i = 0; i < leafCount; ++i) {
+        pool.push_back(new prsr::Node(std::string(1, (char)('A' + rng() % 8)), false, false, true));
+    }
+    while (pool.size() > 1) {
+        size_t a = rng() % pool.size();
+        std::swap(pool[a], pool.back());
+        prsr::Node* left = pool.back();
+        pool.pop_back();
+        size_t b = rng() % pool.size();
+        prsr::Node* node = new prsr::Node(ops[rng() % 4], true);
+        node->children = {left, pool[b]};
+        pool[b] = node;
+    }
+    return pool[0];
+}
+
+} // namespace
+
+// Розгортка 1..1024 проти планування кожного P з нуля, як раніше робив кеш результатів
+void prsr::benchmarkProcessorSweep() {
+    std::vector<int> procCounts;
+    parseProcessorRange("1..1024", procCounts);
+    int threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    std::mt19937 rng(5);
+    std::cout << "\n=== Processor sweep 1.." << procCounts.back() << ": from scratch vs shared analysis ===" << std::endl;
+    std::cout << "  Ops | crit. path | saturated at | from scratch | sweep, 1 thread | sweep, " << threads
+              << " threads | scheduled" << std::endl;
+    for (int leaves : {256, 1024, 4096}) {
+        prsr::Node* tree = randomTree(leaves, rng);
+
+        auto t0 = std::chrono::steady_clock::now();
+        std::vector<int> scratch;
+        for (int p : procCounts) {
+            // Як buildSchedule у кеші: граф і рівні дерева — заново для кожного P
+            auto plan = assignTasksWithDependencies(tree, p);
+            groupByLevels(tree);
+            scratch.push_back(plan.empty() ? 0 : plan.back().endTime);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        SweepResult serial = sweepProcessors(analyzeForSweep(tree), procCounts, 1, false);
+        auto t2 = std::chrono::steady_clock::now();
+        SweepResult parallel = sweepProcessors(analyzeForSweep(tree), procCounts, threads, false);
+        auto t3 = std::chrono::steady_clock::now();
+
+        bool same = true;
+        for (size_t i = 0; i < procCounts.size(); ++i) {
+            same = same && serial.points[i].makespan == scratch[i] && parallel.points[i].makespan == scratch[i];
+        }
+        auto ms = [](auto a, auto b) { return std::chrono::duration<double>(b - a).count() * 1e3; };
+        std::cout << std::setw(5) << leaves - 1 << " | " << std::setw(10) << analyzeForSweep(tree).criticalPath
+                  << " | " << std::setw(12) << parallel.saturatedAt << " | " << std::fixed << std::setprecision(1)
+                  << std::setw(9) << ms(t0, t1) << " ms | " << std::setw(12) << ms(t1, t2) << " ms | "
+                  << std::setw(11) << ms(t2, t3) << " ms | " << std::setw(9) << parallel.computed
+                  << (same ? "" : "  MISMATCH") << std::defaultfloat << std::setprecision(6) << std::endl;
+        delete tree;
+    }
+
+    // Малі випадкові дерева: розгортка з зупинкою проти scheduleTaskGraph для кожного P окремо
+    std::vector<int> smallCounts;
+    parseProcessorRange("1..32", smallCounts);
+    int trees = 20000, differs = 0;
+    for (int i = 0; i < trees; ++i) {
+        prsr::Node* tree = randomTree(2 + (int)(rng() % 63), rng);
+        SweepAnalysis analysis = analyzeForSweep(tree);
+        SweepResult sweep = sweepProcessors(analysis, smallCounts, 1, false);
+        for (size_t k = 0; k < smallCounts.size(); ++k) {
+            int makespan = 0;
+            for (const auto& t : scheduleTaskGraph(analysis.graph, smallCounts[k])) makespan = std::max(makespan, t.endTime);
+            if (makespan != sweep.points[k].makespan) {
+                differs++;
+                break;
+            }
+        }
+        delete tree;
+    }
+    std::cout << "Random trees: " << trees << ", sweep differs from scheduling each P in " << differs
+              << (differs ? "  MISMATCH" : "") << std::endl;
+}
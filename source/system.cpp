@@ -0,0 +1,231 @@
+#include "parser.h"
+#include "modeling.h"
+#include "cache.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <random>
+#include <unordered_map>
+#include <algorithm>
+
+namespace {
+
+std::string trim(const std::string& s) {
+    size_t b = s.find_first_not_of(" \t\r\n");
+    if (b == std::string::npos) return "";
+    size_t e = s.find_last_not_of(" \t\r\n");
+    return s.substr(b, e - b + 1);
+}
+
+// Підграф задач, від яких залежить output; індекси зберігають топологічний порядок
+TaskGraph outputSubgraph(const TaskGraph& graph, int output) {
+    if (output < 0) return TaskGraph();
+    std::vector<char> needed(graph.size(), 0);
+    std::vector<int> stack = {output};
+    needed[output] = 1;
+    while (!stack.empty()) {
+        int t = stack.back();
+        stack.pop_back();
+        for (int p : graph.preds(t)) {
+            if (!needed[p]) {
+                needed[p] = 1;
+                stack.push_back(p);
+            }
+        }
+    }
+    TaskGraphBuilder builder;
+    std::vector<int> remap(graph.size(), -1);
+    for (int i = 0; i < (int)graph.size(); ++i) {
+        if (!needed[i]) continue;
+        std::vector<int> preds;
+        for (int p : graph.preds(i)) preds.push_back(remap[p]);
+        remap[i] = builder.addTask(graph.op(i), preds, graph.release[i]);
+    }
+    return builder.build();
+}
+
+int countOperators(const prsr::Node* root) {
+    int count = 0;
+    std::vector<const prsr::Node*> stack = {root};
+    while (!stack.empty()) {
+        const prsr::Node* n = stack.back();
+        stack.pop_back();
+        if (!n || !n->isOperator) continue;
+        ++count;
+        for (const prsr::Node* child : n->children) stack.push_back(child);
+    }
+    return count;
+}
+
+SimResult listSchedule(const TaskGraph& graph, const MachineModel& machine, bool keepTrace) {
+    std::vector<double> bl = bottomLevels(graph, machine);
+    return simulatePolicy(graph, machine, [&](int task) { return bl[task]; }, keepTrace);
+}
+
+} // namespace
+
+// "X=A+B; Y=A+B*C" або по рядку на вираз; без імені вираз отримує ім'я E1, E2, ...
+bool parseExpressionSystem(const std::string& text, std::vector<NamedExpression>& system) {
+    system.clear();
+    std::string normalized = text;
+    std::replace(normalized.begin(), normalized.end(), '\n', ';');
+    std::stringstream ss(normalized);
+    std::string item;
+    while (std::getline(ss, item, ';')) {
+        item = trim(item);
+        if (item.empty()) continue;
+        NamedExpression e;
+        size_t eq = item.find('=');
+        if (eq == std::string::npos) {
+            e.name = "E" + std::to_string(system.size() + 1);
+            e.expr = item;
+        } else {
+            e.name = trim(item.substr(0, eq));
+            e.expr = trim(item.substr(eq + 1));
+        }
+        if (e.name.empty() || e.expr.empty()) {
+            std::cout << "Error: cannot parse system entry '" << item << "'" << std::endl;
+            return false;
+        }
+        for (const auto& other : system) {
+            if (other.name == e.name) {
+                std::cout << "Error: expression name " << e.name << " is used twice" << std::endl;
+                return false;
+            }
+        }
+        system.push_back(e);
+    }
+    return !system.empty();
+}
+
+// Дерева беруться з кешу результатів і зливаються за структурним хешем вузлів:
+// однакові підвирази — в одному виразі чи в різних — стають однією задачею
+bool buildSystemGraph(const std::vector<NamedExpression>& system, SystemGraph& out) {
+    out = SystemGraph();
+    TaskGraphBuilder builder;
+    std::unordered_map<prsr::Hash128, int, prsr::Hash128Hasher> taskOf;
+    std::vector<int> owner;   // перший вираз, якому знадобилась задача; -2 — кільком
+    for (size_t i = 0; i < system.size(); ++i) {
+        auto analysis = analyzeExpression(system[i].expr, {});
+        if (!analysis->valid) {
+            std::cout << "Error: expression " << system[i].name << " is not valid!" << std::endl;
+            return false;
+        }
+        out.names.push_back(system[i].name);
+        out.corrected.push_back(analysis->corrected);
+        out.treeTasks += countOperators(analysis->root());
+        std::unordered_map<const prsr::Node*, int> idOf;
+        std::vector<std::pair<const prsr::Node*, bool>> stack = {{analysis->root(), false}};
+        while (!stack.empty()) {
+            auto [node, visited] = stack.back();
+            stack.pop_back();
+            if (!node || !node->isOperator) continue;
+            auto found = taskOf.find(node->hash);
+            if (found != taskOf.end()) {
+                // Піддерево вже є в графі — його операції не повторюються
+                idOf[node] = found->second;
+                int& o = owner[found->second];
+                if (o != (int)i && o != -2) o = -2;
+                continue;
+            }
+            if (!visited) {
+                stack.push_back({node, true});
+                for (const prsr::Node* child : node->children) stack.push_back({child, false});
+                continue;
+            }
+            std::vector<int> preds;
+            for (const prsr::Node* child : node->children) {
+                auto c = idOf.find(child);
+                if (c != idOf.end()) preds.push_back(c->second);
+            }
+            int id = builder.addTask(node->value, preds);
+            owner.push_back((int)i);
+            taskOf.emplace(node->hash, id);
+            idOf[node] = id;
+        }
+        auto root = idOf.find(analysis->root());
+        out.outputs.push_back(root == idOf.end() ? -1 : root->second);
+    }
+    out.graph = builder.build();
+    out.sharedTasks = (int)std::count(owner.begin(), owner.end(), -2);
+    return true;
+}
+
+SystemSchedule scheduleSystem(const SystemGraph& system, int procCount) {
+    SystemSchedule result;
+    MachineModel machine = makeUniformMachine(procCount);
+    result.sim = listSchedule(system.graph, machine, true);
+    std::vector<double> finish(system.graph.size(), 0.0);
+    for (const auto& t : result.sim.trace) finish[t.task] = t.end;
+    for (int output : system.outputs) result.completion.push_back(output < 0 ? 0.0 : finish[output]);
+    for (const auto& t : scheduleTaskGraph(system.graph, procCount)) {
+        result.staticMakespan = std::max(result.staticMakespan, t.endTime);
+    }
+    for (int output : system.outputs) {
+        result.separateMakespan += listSchedule(outputSubgraph(system.graph, output), machine, false).makespan;
+    }
+    return result;
+}
+
+// === Система виразів: один граф, одне планування на procCount процесорах ===
+void prsr::modelExpressionSystem(const std::string& systemText, int procCount) {
+    std::vector<NamedExpression> system;
+    if (!parseExpressionSystem(systemText, system)) {
+        std::cout << "Error: the system is empty or not valid!" << std::endl;
+        return;
+    }
+    SystemGraph graph;
+    if (!buildSystemGraph(system, graph)) return;
+    SystemSchedule schedule = scheduleSystem(graph, procCount);
+
+    std::cout << "\n=== Expression system: " << system.size() << " expressions on " << procCount
+              << " processors ===" << std::endl;
+    std::cout << "Operations: " << graph.treeTasks << " in separate trees, " << graph.graph.size()
+              << " in the shared DAG (" << graph.sharedTasks << " used by several expressions)" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (size_t i = 0; i < system.size(); ++i) {
+        std::cout << std::setw(8) << graph.names[i] << " = " << graph.corrected[i] << "  ready at "
+                  << schedule.completion[i] << std::endl;
+    }
+    std::cout << "Joint makespan: " << schedule.sim.makespan << " (static greedy " << schedule.staticMakespan
+              << "), one after another: " << schedule.separateMakespan
+              << std::defaultfloat << std::setprecision(6) << std::endl;
+    if (graph.graph.size() <= 60) {
+        printSimResult(graph.graph, schedule.sim, procCount);
+    } else {
+        computeMetrics(schedule.sim.seqTime, schedule.sim.makespan, schedule.sim.usedProcs, procCount);
+    }
+}
+
+// Випадкові системи зі спільними змінними: скільки дає CSE і спільне планування
+void prsr::benchmarkExpressionSystem() {
+    const std::vector<std::string> terms = {"A*B", "C*D", "E/F", "(A+B)", "(G-H)", "A*C", "B/D", "E*F*G", "H"};
+    const std::vector<std::string> joins = {"+", "-", "*"};
+    std::mt19937 rng(11);
+    std::cout << "\n=== Expression systems: shared DAG vs one expression at a time ===" << std::endl;
+    std::cout << "Exprs | tree ops | DAG ops | procs | joint | sequential | speedup" << std::endl;
+    for (int count : {4, 12, 24, 48}) {
+        std::string text;
+        for (int i = 0; i < count; ++i) {
+            int parts = 3 + rng() % 3;
+            text += "Y" + std::to_string(i) + "=";
+            for (int j = 0; j < parts; ++j) {
+                if (j) text += joins[rng() % joins.size()];
+                text += terms[rng() % terms.size()];
+            }
+            text += ";";
+        }
+        std::vector<NamedExpression> system;
+        SystemGraph graph;
+        if (!parseExpressionSystem(text, system) || !buildSystemGraph(system, graph)) continue;
+        for (int procs : {1, 2, 4, 8}) {
+            SystemSchedule schedule = scheduleSystem(graph, procs);
+            std::cout << std::setw(5) << count << " | " << std::setw(8) << graph.treeTasks << " | " << std::setw(7)
+                      << graph.graph.size() << " | " << std::setw(5) << procs << " | " << std::fixed
+                      << std::setprecision(1) << std::setw(5) << schedule.sim.makespan << " | " << std::setw(10)
+                      << schedule.separateMakespan << " | " << std::setprecision(2) << std::setw(7)
+                      << (schedule.sim.makespan > 0 ? schedule.separateMakespan / schedule.sim.makespan : 0.0)
+                      << std::defaultfloat << std::setprecision(6) << std::endl;
+        }
+    }
+}